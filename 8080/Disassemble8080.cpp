@@ -0,0 +1,111 @@
+#include "Disassemble8080.h"
+#include <cstring> // memcpy
+#include <fstream>
+#include <vector>
+
+namespace {
+   // Two hex digits for every byte value, so a byte is formatted with a single 2 byte copy
+   struct HexTable {
+      char digits[256][2];
+      constexpr HexTable() : digits{} {
+         const char hex[] = "0123456789abcdef";
+         for (int i = 0; i < 256; i++) {
+            digits[i][0] = hex[i >> 4];
+            digits[i][1] = hex[i & 0xf];
+         }
+      }
+   };
+   constexpr HexTable hexTable;
+
+   inline char* hex8(char* out, uint8_t value) {
+      memcpy(out, hexTable.digits[value], 2);
+      return out + 2;
+   }
+}
+
+size_t Disassemble8080Line(const uint8_t* code, uint16_t pc, char* line) {
+   const Opcode8080& op = opcodes8080[code[0]];
+   char* out = line;
+
+   // Address and raw bytes always take the same 14 columns
+   // "pppp bb       "
+   // "pppp bb bb    "
+   // "pppp bb bb bb "
+   out = hex8(out, pc >> 8);
+   out = hex8(out, pc & 0xff);
+   memcpy(out, "          ", 10);
+   switch (op.length) {
+   case 3: hex8(out + 7, code[2]); // fallthrough
+   case 2: hex8(out + 4, code[1]); // fallthrough
+   default: hex8(out + 1, code[0]);
+   }
+   out += 10;
+
+   memcpy(out, op.mnemonic, sizeof(op.mnemonic));
+   out += op.mnemonicLength;
+
+   switch (op.operand) {
+   case Operand8080::None:
+      break;
+   case Operand8080::D8: // #$nn
+      *out++ = '#'; *out++ = '$';
+      out = hex8(out, code[1]);
+      break;
+   case Operand8080::D16: // #$nnnn
+      *out++ = '#';
+      // fallthrough
+   case Operand8080::Adr: // $nnnn
+      *out++ = '$';
+      out = hex8(out, code[2]);
+      out = hex8(out, code[1]);
+      break;
+   }
+
+   return out - line;
+}
+
+size_t Disassemble8080(const uint8_t* rom, size_t size, size_t& offset, char* text, size_t capacity) {
+   char* out = text;
+   char* end = text + capacity;
+
+   while (offset < size && (size_t)(end - out) > DISASSEMBLY8080_LINE) {
+      const uint8_t* code = &rom[offset];
+      uint8_t tail[3] = {};
+      if (offset + opcodes8080[*code].length > size) {
+         // Last instruction is cut off by the end of the image; read zeros past the end
+         memcpy(tail, code, size - offset);
+         code = tail;
+      }
+
+      out += Disassemble8080Line(code, (uint16_t)offset, out);
+      *out++ = '\n';
+      offset += opcodes8080[*code].length;
+   }
+   if (offset > size) // instruction cut off by the end of the image
+      offset = size;
+
+   return out - text;
+}
+
+bool Disassemble8080File(const char* rom, const char* listing) {
+   std::ifstream in(rom, std::ios::binary);
+   if (!in) return false;
+   std::ofstream out(listing, std::ios::binary);
+   if (!out) return false;
+
+   in.seekg(0, std::ios::end);
+   std::vector<uint8_t> image((size_t)in.tellg());
+   in.seekg(0, std::ios::beg);
+   in.read((char*)image.data(), image.size());
+   in.close();
+
+   // Disassemble in pieces so the listing buffer stays a fixed size however large the image is
+   std::vector<char> text(1 << 20);
+   for (size_t offset = 0; offset < image.size();) {
+      size_t n = Disassemble8080(image.data(), image.size(), offset, text.data(), text.size());
+      out.write(text.data(), n);
+   }
+   out.close();
+
+   return true;
+}
@@ -0,0 +1,341 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t
+
+// Operand following an 8080 opcode byte
+enum class Operand8080 : uint8_t {
+   None, // no operand                             1 byte instruction
+   D8,   // immediate data byte, printed #$nn      2 byte instruction
+   D16,  // immediate data word, printed #$nnnn    3 byte instruction
+   Adr   // address word, printed $nnnn            3 byte instruction
+};
+
+// One row of the opcode table: mnemonic text up to the operand, the operand, and the
+// instruction length. Shared by the disassembler and anything else that needs to walk code.
+struct Opcode8080 {
+   char mnemonic[12]; // zero padded so it can be copied as a block
+   uint8_t mnemonicLength;
+   Operand8080 operand;
+   uint8_t length; // opcode byte plus operand bytes
+
+   template<size_t N>
+   constexpr Opcode8080(const char(&text)[N], Operand8080 operand = Operand8080::None)
+      : mnemonic{}, mnemonicLength(N - 1), operand(operand),
+      length(operand == Operand8080::None ? 1 : operand == Operand8080::D8 ? 2 : 3) {
+      for (size_t i = 0; i + 1 < N; i++)
+         mnemonic[i] = text[i];
+   }
+};
+
+inline constexpr Opcode8080 opcodes8080[256] = {
+   /* 0x00 */ { "NOP" },
+   /* 0x01 */ { "LXI    B,", Operand8080::D16 },
+   /* 0x02 */ { "STAX   B" },
+   /* 0x03 */ { "INX    B" },
+   /* 0x04 */ { "INR    B" },
+   /* 0x05 */ { "DCR    B" },
+   /* 0x06 */ { "MVI    B,", Operand8080::D8 },
+   /* 0x07 */ { "RLC" },
+   /* 0x08 */ { "NOP" },
+   /* 0x09 */ { "DAD    B" },
+   /* 0x0a */ { "LDAX   B" },
+   /* 0x0b */ { "DCX    B" },
+   /* 0x0c */ { "INR    C" },
+   /* 0x0d */ { "DCR    C" },
+   /* 0x0e */ { "MVI    C,", Operand8080::D8 },
+   /* 0x0f */ { "RRC" },
+
+   /* 0x10 */ { "NOP" },
+   /* 0x11 */ { "LXI    D,", Operand8080::D16 },
+   /* 0x12 */ { "STAX   D" },
+   /* 0x13 */ { "INX    D" },
+   /* 0x14 */ { "INR    D" },
+   /* 0x15 */ { "DCR    D" },
+   /* 0x16 */ { "MVI    D,", Operand8080::D8 },
+   /* 0x17 */ { "RAL" },
+   /* 0x18 */ { "NOP" },
+   /* 0x19 */ { "DAD    D" },
+   /* 0x1a */ { "LDAX   D" },
+   /* 0x1b */ { "DCX    D" },
+   /* 0x1c */ { "INR    E" },
+   /* 0x1d */ { "DCR    E" },
+   /* 0x1e */ { "MVI    E,", Operand8080::D8 },
+   /* 0x1f */ { "RAR" },
+
+   /* 0x20 */ { "NOP" },
+   /* 0x21 */ { "LXI    H,", Operand8080::D16 },
+   /* 0x22 */ { "SHLD   ", Operand8080::Adr },
+   /* 0x23 */ { "INX    H" },
+   /* 0x24 */ { "INR    H" },
+   /* 0x25 */ { "DCR    H" },
+   /* 0x26 */ { "MVI    H,", Operand8080::D8 },
+   /* 0x27 */ { "DAA" },
+   /* 0x28 */ { "NOP" },
+   /* 0x29 */ { "DAD    H" },
+   /* 0x2a */ { "LHLD   ", Operand8080::Adr },
+   /* 0x2b */ { "DCX    H" },
+   /* 0x2c */ { "INR    L" },
+   /* 0x2d */ { "DCR    L" },
+   /* 0x2e */ { "MVI    L,", Operand8080::D8 },
+   /* 0x2f */ { "CMA" },
+
+   /* 0x30 */ { "NOP" },
+   /* 0x31 */ { "LXI    SP,", Operand8080::D16 },
+   /* 0x32 */ { "STA    ", Operand8080::Adr },
+   /* 0x33 */ { "INX    SP" },
+   /* 0x34 */ { "INR    M" },
+   /* 0x35 */ { "DCR    M" },
+   /* 0x36 */ { "MVI    M,", Operand8080::D8 },
+   /* 0x37 */ { "STC" },
+   /* 0x38 */ { "NOP" },
+   /* 0x39 */ { "DAD    SP" },
+   /* 0x3a */ { "LDA    ", Operand8080::Adr },
+   /* 0x3b */ { "DCX    SP" },
+   /* 0x3c */ { "INR    A" },
+   /* 0x3d */ { "DCR    A" },
+   /* 0x3e */ { "MVI    A,", Operand8080::D8 },
+   /* 0x3f */ { "CMC" },
+
+   /* 0x40 */ { "MOV    B,B" },
+   /* 0x41 */ { "MOV    B,C" },
+   /* 0x42 */ { "MOV    B,D" },
+   /* 0x43 */ { "MOV    B,E" },
+   /* 0x44 */ { "MOV    B,H" },
+   /* 0x45 */ { "MOV    B,L" },
+   /* 0x46 */ { "MOV    B,M" },
+   /* 0x47 */ { "MOV    B,A" },
+   /* 0x48 */ { "MOV    C,B" },
+   /* 0x49 */ { "MOV    C,C" },
+   /* 0x4a */ { "MOV    C,D" },
+   /* 0x4b */ { "MOV    C,E" },
+   /* 0x4c */ { "MOV    C,H" },
+   /* 0x4d */ { "MOV    C,L" },
+   /* 0x4e */ { "MOV    C,M" },
+   /* 0x4f */ { "MOV    C,A" },
+
+   /* 0x50 */ { "MOV    D,B" },
+   /* 0x51 */ { "MOV    D,C" },
+   /* 0x52 */ { "MOV    D,D" },
+   /* 0x53 */ { "MOV    D,E" },
+   /* 0x54 */ { "MOV    D,H" },
+   /* 0x55 */ { "MOV    D,L" },
+   /* 0x56 */ { "MOV    D,M" },
+   /* 0x57 */ { "MOV    D,A" },
+   /* 0x58 */ { "MOV    E,B" },
+   /* 0x59 */ { "MOV    E,C" },
+   /* 0x5a */ { "MOV    E,D" },
+   /* 0x5b */ { "MOV    E,E" },
+   /* 0x5c */ { "MOV    E,H" },
+   /* 0x5d */ { "MOV    E,L" },
+   /* 0x5e */ { "MOV    E,M" },
+   /* 0x5f */ { "MOV    E,A" },
+
+   /* 0x60 */ { "MOV    H,B" },
+   /* 0x61 */ { "MOV    H,C" },
+   /* 0x62 */ { "MOV    H,D" },
+   /* 0x63 */ { "MOV    H,E" },
+   /* 0x64 */ { "MOV    H,H" },
+   /* 0x65 */ { "MOV    H,L" },
+   /* 0x66 */ { "MOV    H,M" },
+   /* 0x67 */ { "MOV    H,A" },
+   /* 0x68 */ { "MOV    L,B" },
+   /* 0x69 */ { "MOV    L,C" },
+   /* 0x6a */ { "MOV    L,D" },
+   /* 0x6b */ { "MOV    L,E" },
+   /* 0x6c */ { "MOV    L,H" },
+   /* 0x6d */ { "MOV    L,L" },
+   /* 0x6e */ { "MOV    L,M" },
+   /* 0x6f */ { "MOV    L,A" },
+
+   /* 0x70 */ { "MOV    M,B" },
+   /* 0x71 */ { "MOV    M,C" },
+   /* 0x72 */ { "MOV    M,D" },
+   /* 0x73 */ { "MOV    M,E" },
+   /* 0x74 */ { "MOV    M,H" },
+   /* 0x75 */ { "MOV    M,L" },
+   /* 0x76 */ { "HLT" },
+   /* 0x77 */ { "MOV    M,A" },
+   /* 0x78 */ { "MOV    A,B" },
+   /* 0x79 */ { "MOV    A,C" },
+   /* 0x7a */ { "MOV    A,D" },
+   /* 0x7b */ { "MOV    A,E" },
+   /* 0x7c */ { "MOV    A,H" },
+   /* 0x7d */ { "MOV    A,L" },
+   /* 0x7e */ { "MOV    A,M" },
+   /* 0x7f */ { "MOV    A,A" },
+
+   /* 0x80 */ { "ADD    B" },
+   /* 0x81 */ { "ADD    C" },
+   /* 0x82 */ { "ADD    D" },
+   /* 0x83 */ { "ADD    E" },
+   /* 0x84 */ { "ADD    H" },
+   /* 0x85 */ { "ADD    L" },
+   /* 0x86 */ { "ADD    M" },
+   /* 0x87 */ { "ADD    A" },
+   /* 0x88 */ { "ADC    B" },
+   /* 0x89 */ { "ADC    C" },
+   /* 0x8a */ { "ADC    D" },
+   /* 0x8b */ { "ADC    E" },
+   /* 0x8c */ { "ADC    H" },
+   /* 0x8d */ { "ADC    L" },
+   /* 0x8e */ { "ADC    M" },
+   /* 0x8f */ { "ADC    A" },
+
+   /* 0x90 */ { "SUB    B" },
+   /* 0x91 */ { "SUB    C" },
+   /* 0x92 */ { "SUB    D" },
+   /* 0x93 */ { "SUB    E" },
+   /* 0x94 */ { "SUB    H" },
+   /* 0x95 */ { "SUB    L" },
+   /* 0x96 */ { "SUB    M" },
+   /* 0x97 */ { "SUB    A" },
+   /* 0x98 */ { "SBB    B" },
+   /* 0x99 */ { "SBB    C" },
+   /* 0x9a */ { "SBB    D" },
+   /* 0x9b */ { "SBB    E" },
+   /* 0x9c */ { "SBB    H" },
+   /* 0x9d */ { "SBB    L" },
+   /* 0x9e */ { "SBB    M" },
+   /* 0x9f */ { "SBB    A" },
+
+   /* 0xa0 */ { "ANA    B" },
+   /* 0xa1 */ { "ANA    C" },
+   /* 0xa2 */ { "ANA    D" },
+   /* 0xa3 */ { "ANA    E" },
+   /* 0xa4 */ { "ANA    H" },
+   /* 0xa5 */ { "ANA    L" },
+   /* 0xa6 */ { "ANA    M" },
+   /* 0xa7 */ { "ANA    A" },
+   /* 0xa8 */ { "XRA    B" },
+   /* 0xa9 */ { "XRA    C" },
+   /* 0xaa */ { "XRA    D" },
+   /* 0xab */ { "XRA    E" },
+   /* 0xac */ { "XRA    H" },
+   /* 0xad */ { "XRA    L" },
+   /* 0xae */ { "XRA    M" },
+   /* 0xaf */ { "XRA    A" },
+
+   /* 0xb0 */ { "ORA    B" },
+   /* 0xb1 */ { "ORA    C" },
+   /* 0xb2 */ { "ORA    D" },
+   /* 0xb3 */ { "ORA    E" },
+   /* 0xb4 */ { "ORA    H" },
+   /* 0xb5 */ { "ORA    L" },
+   /* 0xb6 */ { "ORA    M" },
+   /* 0xb7 */ { "ORA    A" },
+   /* 0xb8 */ { "CMP    B" },
+   /* 0xb9 */ { "CMP    C" },
+   /* 0xba */ { "CMP    D" },
+   /* 0xbb */ { "CMP    E" },
+   /* 0xbc */ { "CMP    H" },
+   /* 0xbd */ { "CMP    L" },
+   /* 0xbe */ { "CMP    M" },
+   /* 0xbf */ { "CMP    A" },
+
+   /* 0xc0 */ { "RNZ" },
+   /* 0xc1 */ { "POP    B" },
+   /* 0xc2 */ { "JNZ    ", Operand8080::Adr },
+   /* 0xc3 */ { "JMP    ", Operand8080::Adr },
+   /* 0xc4 */ { "CNZ    ", Operand8080::Adr },
+   /* 0xc5 */ { "PUSH   B" },
+   /* 0xc6 */ { "ADI    ", Operand8080::D8 },
+   /* 0xc7 */ { "RST    0" },
+   /* 0xc8 */ { "RZ" },
+   /* 0xc9 */ { "RET" },
+   /* 0xca */ { "JZ     ", Operand8080::Adr },
+   /* 0xcb */ { "JMP    ", Operand8080::Adr },
+   /* 0xcc */ { "CZ     ", Operand8080::Adr },
+   /* 0xcd */ { "CALL   ", Operand8080::Adr },
+   /* 0xce */ { "ACI    ", Operand8080::D8 },
+   /* 0xcf */ { "RST    1" },
+
+   /* 0xd0 */ { "RNC" },
+   /* 0xd1 */ { "POP    D" },
+   /* 0xd2 */ { "JNC    ", Operand8080::Adr },
+   /* 0xd3 */ { "OUT    ", Operand8080::D8 },
+   /* 0xd4 */ { "CNC    ", Operand8080::Adr },
+   /* 0xd5 */ { "PUSH   D" },
+   /* 0xd6 */ { "SUI    ", Operand8080::D8 },
+   /* 0xd7 */ { "RST    2" },
+   /* 0xd8 */ { "RC" },
+   /* 0xd9 */ { "RET" },
+   /* 0xda */ { "JC     ", Operand8080::Adr },
+   /* 0xdb */ { "IN     ", Operand8080::D8 },
+   /* 0xdc */ { "CC     ", Operand8080::Adr },
+   /* 0xdd */ { "CALL   ", Operand8080::Adr },
+   /* 0xde */ { "SBI    ", Operand8080::D8 },
+   /* 0xdf */ { "RST    3" },
+
+   /* 0xe0 */ { "RPO" },
+   /* 0xe1 */ { "POP    H" },
+   /* 0xe2 */ { "JPO    ", Operand8080::Adr },
+   /* 0xe3 */ { "XTHL" },
+   /* 0xe4 */ { "CPO    ", Operand8080::Adr },
+   /* 0xe5 */ { "PUSH   H" },
+   /* 0xe6 */ { "ANI    ", Operand8080::D8 },
+   /* 0xe7 */ { "RST    4" },
+   /* 0xe8 */ { "RPE" },
+   /* 0xe9 */ { "PCHL" },
+   /* 0xea */ { "JPE    ", Operand8080::Adr },
+   /* 0xeb */ { "XCHG" },
+   /* 0xec */ { "CPE    ", Operand8080::Adr },
+   /* 0xed */ { "CALL   ", Operand8080::Adr },
+   /* 0xee */ { "XRI    ", Operand8080::D8 },
+   /* 0xef */ { "RST    5" },
+
+   /* 0xf0 */ { "RP" },
+   /* 0xf1 */ { "POP    PSW" },
+   /* 0xf2 */ { "JP     ", Operand8080::Adr },
+   /* 0xf3 */ { "DI" },
+   /* 0xf4 */ { "CP     ", Operand8080::Adr },
+   /* 0xf5 */ { "PUSH   PSW" },
+   /* 0xf6 */ { "ORI    ", Operand8080::D8 },
+   /* 0xf7 */ { "RST    6" },
+   /* 0xf8 */ { "RM" },
+   /* 0xf9 */ { "SPHL" },
+   /* 0xfa */ { "JM     ", Operand8080::Adr },
+   /* 0xfb */ { "EI" },
+   /* 0xfc */ { "CM     ", Operand8080::Adr },
+   /* 0xfd */ { "CALL   ", Operand8080::Adr },
+   /* 0xfe */ { "CPI    ", Operand8080::D8 },
+   /* 0xff */ { "RST    7" },
+};
+
+// Clock cycles per opcode from the 8080 data sheet. Conditional CALL and RET are listed
+// not taken; they take 6 more cycles when the condition holds.
+inline constexpr uint8_t cycles8080[256] = {
+    4, 10,  7,  5,  5,  5,  7,  4,  4, 10,  7,  5,  5,  5,  7,  4, // 0x00
+    4, 10,  7,  5,  5,  5,  7,  4,  4, 10,  7,  5,  5,  5,  7,  4, // 0x10
+    4, 10, 16,  5,  5,  5,  7,  4,  4, 10, 16,  5,  5,  5,  7,  4, // 0x20
+    4, 10, 13,  5, 10, 10, 10,  4,  4, 10, 13,  5,  5,  5,  7,  4, // 0x30
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5, // 0x40
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5, // 0x50
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5, // 0x60
+    7,  7,  7,  7,  7,  7,  7,  7,  5,  5,  5,  5,  5,  5,  7,  5, // 0x70
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4, // 0x80
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4, // 0x90
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4, // 0xa0
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4, // 0xb0
+    5, 10, 10, 10, 11, 11,  7, 11,  5, 10, 10, 10, 11, 17,  7, 11, // 0xc0
+    5, 10, 10, 10, 11, 11,  7, 11,  5, 10, 10, 10, 11, 17,  7, 11, // 0xd0
+    5, 10, 10, 18, 11, 11,  7, 11,  5,  5, 10,  4, 11, 17,  7, 11, // 0xe0
+    5, 10, 10,  4, 11, 11,  7, 11,  5,  5, 10,  4, 11, 17,  7, 11, // 0xf0
+};
+
+// Room one disassembled line needs: "pppp bb bb bb " plus the longest mnemonic and operand
+constexpr size_t DISASSEMBLY8080_LINE = 32;
+
+// Writes "pppp bb bb bb MNEMONIC operand" for the instruction at code, which is located at
+// address pc, into line (at least DISASSEMBLY8080_LINE characters, not zero terminated).
+// Reads opcodes8080[code[0]].length bytes of code. Returns the number of characters written.
+size_t Disassemble8080Line(const uint8_t* code, uint16_t pc, char* line);
+
+// Linearly disassembles the ROM image rom[0..size) starting at offset, one '\n' terminated
+// line per instruction, until the image ends or text has less than a line of room left.
+// The image is assumed to be loaded at address 0. Advances offset past the instructions
+// written and returns the number of characters written to text.
+size_t Disassemble8080(const uint8_t* rom, size_t size, size_t& offset, char* text, size_t capacity);
+
+// Disassembles the whole ROM image in file rom into the listing file. Returns false if
+// either file could not be opened.
+bool Disassemble8080File(const char* rom, const char* listing);
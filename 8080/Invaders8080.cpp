@@ -0,0 +1,130 @@
+#include "Invaders8080.h"
+#include "Disassemble8080.h"
+#include "Runtime8080.h"
+
+namespace {
+   // Instructions that only read memory and change registers and flags. A loop of
+   // these that comes back to the same state will repeat until an interrupt.
+   bool pure8080(uint8_t op) {
+      if (op >= 0x40 && op < 0x80) // MOV, except MOV M,r and HLT
+         return (op & 0xF8) != 0x70;
+      if (op >= 0x80 && op < 0xC0) // ALU register and memory
+         return true;
+      switch (op & 0xC7) {
+      case 0x04: case 0x05: case 0x06: // INR, DCR, MVI; not on M
+         return (op & 0x38) != 0x30;
+      case 0xC2: case 0xC6: // Jcc, ALU immediate
+         return true;
+      }
+      switch (op) {
+      case 0x00: case 0x01: case 0x11: case 0x21: case 0x31: // NOP, LXI
+      case 0x03: case 0x13: case 0x23: case 0x33: case 0x0B: case 0x1B: case 0x2B: case 0x3B: // INX, DCX
+      case 0x09: case 0x19: case 0x29: case 0x39: // DAD
+      case 0x0A: case 0x1A: case 0x2A: case 0x3A: // LDAX, LHLD, LDA
+      case 0x07: case 0x0F: case 0x17: case 0x1F: // RLC, RRC, RAL, RAR
+      case 0x27: case 0x2F: case 0x37: case 0x3F: // DAA, CMA, STC, CMC
+      case 0xC3: case 0xE9: case 0xEB: case 0xF9: // JMP, PCHL, XCHG, SPHL
+         return true;
+      default:
+         return false;
+      }
+   }
+
+   bool sameState(const decltype(State8080::Reg)& a, const decltype(State8080::Reg)& b) {
+      return a.a == b.a && a.bc == b.bc && a.de == b.de && a.hl == b.hl && a.sp == b.sp && a.pc == b.pc
+         && a.f.c == b.f.c && a.f.p == b.f.p && a.f.a == b.f.a && a.f.z == b.f.z && a.f.s == b.f.s;
+   }
+}
+
+// Whether the next step from pc, a whole block or one instruction, is pure
+bool Invaders8080::pureStep(uint16_t pc) const {
+   const AotBlock8080* block = Runtime8080::find(pc);
+   uint32_t end = pc + (block != nullptr ? block->length : 1);
+   for (uint32_t address = pc; address < end && address < sizeof(cpu.memory); address += opcodes8080[cpu.memory[address]].length) {
+      if (!pure8080(cpu.memory[address]))
+         return false;
+   }
+   return true;
+}
+
+// Called before each step with the pc it starts from. Returns true if cycles were
+// skipped, so the caller checks for the interrupt and the end of the run again.
+bool Invaders8080::track(uint16_t from) {
+   bool skipped = false;
+   if (from == head && cpu.cycles > headCycles) {
+      if (pure && sameState(cpu.Reg, snapshot)) {
+         // Every iteration from here on is identical; skip the whole ones before the
+         // interrupt or the end of the run, whichever is first
+         uint64_t iteration = cpu.cycles - headCycles;
+         uint64_t until = nextInterrupt < end ? nextInterrupt : end;
+         uint64_t skip = cpu.cycles < until ? (until - cpu.cycles) / iteration * iteration : 0;
+         cpu.cycles += skip;
+         idleCyclesSkipped += skip;
+         idleLoopsSkipped += skip != 0;
+         skipped = skip != 0;
+      }
+      // Start a new iteration either way; loops that count converge here once they stop changing
+      snapshot = cpu.Reg;
+      headCycles = cpu.cycles;
+      pure = true;
+   } else if (from < head || from > head + IDLE_LOOP_WINDOW) {
+      tracking = false;
+      return false;
+   }
+
+   if (pure)
+      pure = pureStep(from);
+   return skipped;
+}
+
+void Invaders8080::run(uint64_t frames) {
+   end = frames * CYCLES_PER_FRAME;
+
+   while (cpu.cycles < end) {
+      if (cpu.cycles >= nextInterrupt) {
+         cpu.generateInterrupt(nextRst);
+         nextRst = (nextRst == 0xCF ? 0xD7 : 0xCF);
+         nextInterrupt += CYCLES_PER_HALF_FRAME;
+         tracking = false;
+      }
+
+      uint16_t from = cpu.Reg.pc;
+      if (tracking && track(from))
+         continue;
+
+      uint64_t before = cpu.cycles;
+      Runtime8080::step(cpu);
+
+      if (cpu.cycles == before) // Halted; wait for the next interrupt
+         cpu.cycles = nextInterrupt;
+
+      // A short backward jump starts a candidate loop at its target
+      if (skipIdleLoops && !tracking && cpu.Reg.pc <= from && from - cpu.Reg.pc <= IDLE_LOOP_WINDOW) {
+         tracking = true;
+         pure = true;
+         head = cpu.Reg.pc;
+         headCycles = cpu.cycles;
+         snapshot = cpu.Reg;
+      }
+   }
+}
+
+uint64_t Invaders8080::hash() const {
+   uint64_t h = 14695981039346656037ull;
+   auto add = [&h](uint64_t value, int bytes) {
+      for (int i = 0; i < bytes; i++, value >>= 8)
+         h = (h ^ (value & 0xff)) * 1099511628211ull;
+   };
+
+   add(cpu.Reg.a, 1);
+   add(cpu.Reg.bc, 2);
+   add(cpu.Reg.de, 2);
+   add(cpu.Reg.hl, 2);
+   add(cpu.Reg.sp, 2);
+   add(cpu.Reg.pc, 2);
+   add(cpu.Reg.f.c | cpu.Reg.f.p << 1 | cpu.Reg.f.a << 2 | cpu.Reg.f.z << 3 | cpu.Reg.f.s << 4, 1);
+   add(cpu.cycles, 8);
+   for (uint8_t byte : cpu.memory)
+      add(byte, 1);
+   return h;
+}
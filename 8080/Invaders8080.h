@@ -0,0 +1,48 @@
+#pragma once
+#include "State8080.h"
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t, uint64_t
+
+// The Space Invaders board around a State8080: a 2 MHz clock and the two video
+// interrupts per frame, RST 1 at mid-screen and RST 2 at vertical blank.
+//
+// The game's main loop spins reading RAM flags that only the interrupt handlers
+// change. With skipIdleLoops set, such a spin is detected and whole iterations up
+// to the next interrupt are skipped, charging their cycles. Only iterations are
+// skipped, so the interrupt arrives at the same instruction as with full execution
+// and hash() matches.
+class Invaders8080 {
+public:
+   static constexpr uint64_t CYCLES_PER_HALF_FRAME = 2000000 / 120;
+   static constexpr uint64_t CYCLES_PER_FRAME = 2 * CYCLES_PER_HALF_FRAME;
+   static constexpr uint16_t IDLE_LOOP_WINDOW = 32; // Longest loop body considered, in bytes
+
+   explicit Invaders8080(State8080& cpu) : cpu(cpu) {}
+
+   bool skipIdleLoops = true;
+   uint64_t idleCyclesSkipped = 0;
+   size_t idleLoopsSkipped = 0;
+
+   // Run until the given number of frames have passed since power on
+   void run(uint64_t frames);
+
+   // FNV-1a over registers, memory and the cycle count
+   uint64_t hash() const;
+
+private:
+   State8080& cpu;
+   uint64_t nextInterrupt = CYCLES_PER_HALF_FRAME;
+   uint64_t end = 0; // Cycle count run() stops at
+   uint8_t nextRst = 0xCF; // RST 1, then RST 2 (0xD7)
+
+   // Idle loop candidate: a short backward jump to head, followed until control
+   // either returns to head or leaves the window
+   bool tracking = false;
+   bool pure = false;    // Nothing since the snapshot wrote memory, did IO or touched interrupts
+   uint16_t head = 0;
+   uint64_t headCycles = 0;
+   decltype(State8080::Reg) snapshot;
+
+   bool pureStep(uint16_t pc) const;
+   bool track(uint16_t from);
+};
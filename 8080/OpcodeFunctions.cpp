@@ -426,7 +426,7 @@ void State8080::PUSH(uint16_t val) {
 //    Zuxiliary Carry may be changed. Otherwise, none are affected.
 uint16_t State8080::POP() {
    uint16_t value = mem<uint16_t>(Reg.sp);
-   Reg.sp -= 2;
+   Reg.sp += 2;
    return value;
    // Condition bits are not set by this function.
    // Calling function should set condition bits if register pair PSW is specified.
@@ -486,4 +486,117 @@ void State8080::CALL(uint16_t address) {
 //    None
 void State8080::RET() {
    Reg.pc = POP();
-}
\ No newline at end of file
+}
+
+// RLC Rotate Accumulator Left (pg 21)
+//
+// Format: 00|000|111
+//
+// Description:
+//       The Carry bit is set equal to the high-order bit of the accumulator.
+//    The contents of the accumulator are rotated one bit position to the left,
+//    with the high-order bit being transferred to the low-order bit position
+//    of the accumulator.
+//
+// Condition bits affected:
+//    Carry
+void State8080::RLC() {
+   Reg.f.c = ((Reg.a & 0x80) == 0x80 ? SET : RESET); // Carry flag
+   Reg.a = (Reg.a << 1) | (Reg.a >> 7);
+}
+
+// RRC Rotate Accumulator Right (pg 21)
+//
+// Format: 00|001|111
+//
+// Description:
+//       The carry bit is set equal to the low-order bit of the accumulator.
+//    The contents of the accumulator are rotated one bit position to the
+//    right, with the low-order bit being transferred to the high-order bit
+//    position of the accumulator.
+//
+// Condition bits affected:
+//    Carry
+void State8080::RRC() {
+   Reg.f.c = ((Reg.a & 0x01) == 0x01 ? SET : RESET); // Carry flag
+   Reg.a = (Reg.a >> 1) | (Reg.a << 7);
+}
+
+// RAL Rotate Accumulator Left Through Carry (pg 22)
+//
+// Format: 00|010|111
+//
+// Description:
+//       The contents of the accumulator are rotated one bit position to the
+//    left. The high-order bit of the accumulator replaces the Carry bit,
+//    while the Carry bit replaces the low-order bit of the accumulator.
+//
+// Condition bits affected:
+//    Carry
+void State8080::RAL() {
+   uint8_t carry = Reg.f.c; // Copy of carry bit
+   Reg.f.c = ((Reg.a & 0x80) == 0x80 ? SET : RESET); // Carry flag
+   Reg.a = (Reg.a << 1) | carry;
+}
+
+// RAR Rotate Accumulator Right Through Carry (pg 22)
+//
+// Format: 00|011|111
+//
+// Description:
+//       The contents of the accumulator are rotated one bit position to the
+//    right. The low-order bit of the accumulator replaces the carry bit,
+//    while the carry bit replaces the high-order bit of the accumulator.
+//
+// Condition bits affected:
+//    Carry
+void State8080::RAR() {
+   uint8_t carry = Reg.f.c; // Copy of carry bit
+   Reg.f.c = ((Reg.a & 0x01) == 0x01 ? SET : RESET); // Carry flag
+   Reg.a = (Reg.a >> 1) | (carry << 7);
+}
+
+// PUSH PSW Push Flags And Accumulator (pg 22)
+//
+// Format: 11|110|101
+//
+// Description:
+//       The flags are packed into the format described under PUSH and
+//    pushed along with the accumulator.
+//
+// Condition bits affected:
+//    None
+void State8080::PUSH_PSW() {
+   Reg.flagByte = // Convert flags to byte
+      (Reg.f.s << 7) |
+      (Reg.f.z << 6) |
+      (0 << 5)       |
+      (Reg.f.a << 4) |
+      (0 << 3)       |
+      (Reg.f.p << 2) |
+      (1 << 1)       |
+      (Reg.f.c << 0);
+
+   PUSH(Reg.psw);
+}
+
+// POP PSW Pop Flags And Accumulator (pg 23)
+//
+// Format: 11|110|001
+//
+// Description:
+//       The accumulator and the packed flags are popped, and the five
+//    condition bits are restored from the flag byte.
+//
+// Condition bits affected:
+//    Carry, Sign, Zero, Parity, Auxiliary Carry
+void State8080::POP_PSW() {
+   Reg.psw = POP();
+
+   // Extract flags from byte
+   Reg.f.s = ((Reg.flagByte & (1 << 7)) == (1 << 7)); // Sign bit
+   Reg.f.z = ((Reg.flagByte & (1 << 6)) == (1 << 6)); // Zero bit
+   Reg.f.a = ((Reg.flagByte & (1 << 4)) == (1 << 4)); // Auxiliary Carry bit
+   Reg.f.p = ((Reg.flagByte & (1 << 2)) == (1 << 2)); // Parity bit
+   Reg.f.c = ((Reg.flagByte & (1 << 0)) == (1 << 0)); // Carry bit
+}
@@ -0,0 +1,386 @@
+#include "Recompiler8080.h"
+#include "Disassemble8080.h"
+#include <cstdio> // snprintf
+#include <fstream>
+#include <vector>
+
+namespace {
+   // Operand spellings in the order of the 3 bit register field
+   const char* const registers[8] = {
+      "s.Reg.b", "s.Reg.c", "s.Reg.d", "s.Reg.e", "s.Reg.h", "s.Reg.l", "s.mem<uint8_t>(s.Reg.hl)", "s.Reg.a"
+   };
+   // 2 bit register pair field; PUSH/POP use PSW in place of SP
+   const char* const pairs[4] = { "s.Reg.bc", "s.Reg.de", "s.Reg.hl", "s.Reg.sp" };
+   // 3 bit ALU field of 10|ALU|SSS and 11|ALU|110
+   const char* const alu[8] = { "ADD", "ADC", "SUB", "SBB", "ANA", "XRA", "ORA", "CMP" };
+   // 3 bit condition field of Jcc, Ccc and Rcc: NZ Z NC C PO PE P M
+   const char* const conditions[8] = {
+      "s.Reg.f.z != SET", "s.Reg.f.z == SET", "s.Reg.f.c != SET", "s.Reg.f.c == SET",
+      "s.Reg.f.p != SET", "s.Reg.f.p == SET", "s.Reg.f.s != SET", "s.Reg.f.s == SET"
+   };
+
+   enum class Flow { Next, Branch, Call, Return, Jump, Stop };
+
+   // Undocumented opcodes are left to the interpreter
+   bool interpreted(uint8_t op) {
+      switch (op) {
+      case 0x08: case 0x10: case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+      case 0xcb: case 0xd9: case 0xdd: case 0xed: case 0xfd:
+         return true;
+      default:
+         return false;
+      }
+   }
+
+   // How an instruction leaves the block
+   //    Next   continues with the following instruction
+   //    Branch conditional jump to target, otherwise falls through
+   //    Call   CALL, Ccc and RST; execution resumes after it on return
+   //    Return RET and Rcc
+   //    Jump   JMP to target
+   //    Stop   PCHL and HLT
+   Flow flow(uint8_t op) {
+      if (op == 0xc3) return Flow::Jump;
+      if (op == 0xcd || (op & 0xc7) == 0xc4 || (op & 0xc7) == 0xc7) return Flow::Call;
+      if ((op & 0xc7) == 0xc2) return Flow::Branch;
+      if (op == 0xc9 || (op & 0xc7) == 0xc0) return Flow::Return;
+      if (op == 0xe9 || op == 0x76) return Flow::Stop;
+      return Flow::Next;
+   }
+
+   uint16_t target(const uint8_t* code) {
+      if ((code[0] & 0xc7) == 0xc7) // RST n
+         return code[0] & 0x38;
+      return code[1] | (code[2] << 8);
+   }
+
+   // Which handler an instruction runs, from flag liveness
+   //    Flags    the interpreter's helper, every flag updated
+   //    NoFlags  Runtime8080::NoFlags, no flag updated
+   //    ZeroFlag Runtime8080::ZeroFlag, only Z updated
+   enum class Variant { Flags, NoFlags, ZeroFlag };
+
+   // Emit the statement for one instruction at pc; next is the address after it
+   void statement(std::string& out, const uint8_t* code, uint16_t next, Variant variant) {
+      const uint8_t op = code[0];
+      const char* ns = variant == Variant::Flags ? "R" : variant == Variant::NoFlags ? "F" : "Z";
+      const bool flags = variant == Variant::Flags;
+      const char* ddd = registers[(op >> 3) & 7];
+      const char* sss = registers[op & 7];
+      const char* rp = pairs[(op >> 4) & 3];
+      const char* cc = conditions[(op >> 3) & 7];
+      const unsigned d8 = code[1];
+      const unsigned d16 = code[1] | (code[2] << 8);
+      char s[160] = "";
+
+      if (op >= 0x40 && op < 0x80 && op != 0x76) { // MOV
+         if ((op >> 3 & 7) != (op & 7))
+            snprintf(s, sizeof(s), "%s = %s;", ddd, sss);
+      } else if (op >= 0x80 && op < 0xc0) { // ADD ADC SUB SBB ANA XRA ORA CMP
+         snprintf(s, sizeof(s), "%s::%s(s, %s);", ns, alu[(op >> 3) & 7], sss);
+      } else switch (op & 0xc7) {
+      case 0x04: snprintf(s, sizeof(s), "%s::INR(s, %s);", ns, ddd); break;
+      case 0x05: snprintf(s, sizeof(s), "%s::DCR(s, %s);", ns, ddd); break;
+      case 0x06: snprintf(s, sizeof(s), "%s = 0x%02x;", ddd, d8); break;
+      case 0xc0: snprintf(s, sizeof(s), "s.Reg.pc = 0x%04x; if (%s) { R::RET(s); s.cycles += 6; }", next, cc); break;
+      case 0xc2: snprintf(s, sizeof(s), "s.Reg.pc = (%s) ? 0x%04x : 0x%04x;", cc, d16, next); break;
+      case 0xc4: snprintf(s, sizeof(s), "s.Reg.pc = 0x%04x; if (%s) { R::CALL(s, 0x%04x); s.cycles += 6; }", next, cc, d16); break;
+      case 0xc6: snprintf(s, sizeof(s), "%s::%s(s, 0x%02x);", ns, alu[(op >> 3) & 7], d8); break;
+      case 0xc7: snprintf(s, sizeof(s), "s.Reg.pc = 0x%04x; R::CALL(s, 0x%04x);", next, op & 0x38); break;
+      default: switch (op & 0xcf) {
+      case 0x01: snprintf(s, sizeof(s), "%s = 0x%04x;", rp, d16); break;
+      case 0x03: snprintf(s, sizeof(s), "%s += 1;", rp); break;
+      case 0x09: snprintf(s, sizeof(s), "%s::DAD(s, %s);", ns, rp); break;
+      case 0x0b: snprintf(s, sizeof(s), "%s -= 1;", rp); break;
+      case 0xc1: snprintf(s, sizeof(s), op == 0xf1 ? "R::POP_PSW(s);" : "%s = R::POP(s);", rp); break;
+      case 0xc5: snprintf(s, sizeof(s), op == 0xf5 ? "R::PUSH_PSW(s);" : "R::PUSH(s, %s);", rp); break;
+      default: switch (op) {
+      case 0x02: case 0x12: snprintf(s, sizeof(s), "s.mem<uint8_t>(%s) = s.Reg.a;", rp); break;
+      case 0x0a: case 0x1a: snprintf(s, sizeof(s), "s.Reg.a = s.mem<uint8_t>(%s);", rp); break;
+      case 0x22: snprintf(s, sizeof(s), "s.mem<uint16_t>(0x%04x) = s.Reg.hl;", d16); break;
+      case 0x2a: snprintf(s, sizeof(s), "s.Reg.hl = s.mem<uint16_t>(0x%04x);", d16); break;
+      case 0x32: snprintf(s, sizeof(s), "s.mem<uint8_t>(0x%04x) = s.Reg.a;", d16); break;
+      case 0x3a: snprintf(s, sizeof(s), "s.Reg.a = s.mem<uint8_t>(0x%04x);", d16); break;
+      case 0x07: snprintf(s, sizeof(s), "%s::RLC(s);", ns); break;
+      case 0x0f: snprintf(s, sizeof(s), "%s::RRC(s);", ns); break;
+      case 0x17: snprintf(s, sizeof(s), "%s::RAL(s);", ns); break;
+      case 0x1f: snprintf(s, sizeof(s), "%s::RAR(s);", ns); break;
+      case 0x27: snprintf(s, sizeof(s), "R::DAA(s);"); break;
+      case 0x2f: snprintf(s, sizeof(s), "s.Reg.a = ~s.Reg.a;"); break;
+      case 0x37: if (flags) snprintf(s, sizeof(s), "s.Reg.f.c = 1;"); break;
+      case 0x3f: if (flags) snprintf(s, sizeof(s), "s.Reg.f.c = !s.Reg.f.c;"); break;
+      case 0x76: snprintf(s, sizeof(s), "s.Reg.pc = 0x%04x; R::HLT(s);", next); break;
+      case 0xc3: snprintf(s, sizeof(s), "s.Reg.pc = 0x%04x;", d16); break;
+      case 0xc9: snprintf(s, sizeof(s), "R::RET(s);"); break;
+      case 0xcd: snprintf(s, sizeof(s), "s.Reg.pc = 0x%04x; R::CALL(s, 0x%04x);", next, d16); break;
+      case 0xd3: snprintf(s, sizeof(s), "R::OUT(s, 0x%02x);", d8); break;
+      case 0xdb: snprintf(s, sizeof(s), "R::IN(s, 0x%02x);", d8); break;
+      case 0xe3: snprintf(s, sizeof(s), "std::swap(s.Reg.hl, s.mem<uint16_t>(s.Reg.sp));"); break;
+      case 0xe9: snprintf(s, sizeof(s), "s.Reg.pc = s.Reg.hl;"); break;
+      case 0xeb: snprintf(s, sizeof(s), "std::swap(s.Reg.hl, s.Reg.de);"); break;
+      case 0xf3: snprintf(s, sizeof(s), "R::DI(s);"); break;
+      case 0xf9: snprintf(s, sizeof(s), "s.Reg.sp = s.Reg.hl;"); break;
+      case 0xfb: snprintf(s, sizeof(s), "R::EI(s);"); break;
+      default: break; // NOP
+      }}}
+
+      if (s[0] != '\0') {
+         out += "      ";
+         out += s;
+         out += '\n';
+      }
+   }
+
+   // Condition flags as a bit set for liveness
+   enum : uint8_t { FLAG_C = 1, FLAG_P = 2, FLAG_A = 4, FLAG_Z = 8, FLAG_S = 16, FLAGS_ALL = 31 };
+   const uint8_t conditionFlags[8] = { FLAG_Z, FLAG_Z, FLAG_C, FLAG_C, FLAG_P, FLAG_P, FLAG_S, FLAG_S };
+
+   // Flags an instruction reads (uses) and writes (defs). removable is set when
+   // a flag-free variant exists, so the instruction can skip its flag updates
+   // once none of its defs are live.
+   void flagEffects(uint8_t op, uint8_t& uses, uint8_t& defs, bool& removable) {
+      uses = 0;
+      defs = 0;
+      removable = true;
+
+      if ((op >= 0x80 && op < 0xc0) || (op & 0xc7) == 0xc6) { // ALU register, memory and immediate
+         defs = FLAGS_ALL;
+         if (((op >> 3) & 7) == 1 || ((op >> 3) & 7) == 3) // ADC, SBB
+            uses = FLAG_C;
+      } else if ((op & 0xc6) == 0x04) { // INR, DCR
+         defs = FLAG_Z | FLAG_S | FLAG_P | FLAG_A;
+      } else if ((op & 0xcf) == 0x09) { // DAD
+         defs = FLAG_C;
+      } else if ((op & 0xc7) == 0xc0 || (op & 0xc7) == 0xc2 || (op & 0xc7) == 0xc4) { // Rcc, Jcc, Ccc
+         uses = conditionFlags[(op >> 3) & 7];
+         removable = false;
+      } else switch (op) {
+      case 0x07: case 0x0f: case 0x37: // RLC, RRC, STC
+         defs = FLAG_C; break;
+      case 0x17: case 0x1f: case 0x3f: // RAL, RAR, CMC
+         uses = FLAG_C; defs = FLAG_C; break;
+      case 0x27: // DAA
+         uses = FLAG_C | FLAG_A; defs = FLAGS_ALL; removable = false; break;
+      case 0xf1: // POP PSW
+         defs = FLAGS_ALL; removable = false; break;
+      case 0xf5: // PUSH PSW
+         uses = FLAGS_ALL; removable = false; break;
+      default:
+         removable = false; break;
+      }
+   }
+
+   // ALU operations, INR and DCR have a ZeroFlag variant
+   bool zeroVariant(uint8_t op) {
+      return (op >= 0x80 && op < 0xc0) || (op & 0xc7) == 0xc6 || (op & 0xc6) == 0x04;
+   }
+
+   void comment(std::string& out, const uint8_t* code, uint16_t pc) {
+      char line[DISASSEMBLY8080_LINE];
+      out += "      // ";
+      out.append(line, Disassemble8080Line(code, pc, line));
+      out += '\n';
+   }
+}
+
+std::string Recompile8080(const uint8_t* rom, size_t size, const char* name, bool eliminateDeadFlags) {
+   if (size > 0x10000)
+      size = 0x10000;
+
+   // Discover block entry points by recursive descent from the reset and RST vectors
+   std::vector<bool> leader(size), reached(size);
+   std::vector<size_t> work;
+   for (size_t vector = 0x38 + 8; vector > 0; vector -= 8)
+      work.push_back(vector - 8);
+
+   while (!work.empty()) {
+      size_t pc = work.back();
+      work.pop_back();
+      if (pc >= size || leader[pc])
+         continue;
+      leader[pc] = true;
+
+      // Walk the block; running into an already walked instruction makes it a leader too
+      for (;;) {
+         if (pc < size && reached[pc]) {
+            work.push_back(pc);
+            break;
+         }
+         if (pc >= size)
+            break;
+         const uint8_t* code = &rom[pc];
+         size_t next = pc + opcodes8080[*code].length;
+         if (interpreted(*code) || next > size)
+            break;
+         reached[pc] = true;
+
+         Flow f = flow(*code);
+         if (f == Flow::Branch || f == Flow::Call || f == Flow::Jump)
+            work.push_back(target(code));
+         if (f == Flow::Branch || f == Flow::Call)
+            work.push_back(next);
+         if (f != Flow::Next)
+            break;
+         pc = next;
+      }
+   }
+
+   std::string out;
+   out.reserve(size * 64);
+   out += "// Generated from ";
+   out += name;
+   out += " by 8080 -r. Do not edit.\n";
+   out += "#include \"Runtime8080.h\"\n";
+   out += "#include <utility> // std::swap\n\n";
+   out += "namespace {\n";
+   out += "   using R = Runtime8080;\n";
+   out += "   using F = Runtime8080::NoFlags;\n";
+   out += "   using Z = Runtime8080::ZeroFlag;\n\n";
+
+   char text[96];
+   snprintf(text, sizeof(text), "   const uint8_t rom[0x%zx] = {", size);
+   out += text;
+   for (size_t i = 0; i < size; i++) {
+      snprintf(text, sizeof(text), "%s0x%02x,", i % 16 == 0 ? "\n      " : " ", rom[i]);
+      out += text;
+   }
+   out += "\n   };\n";
+
+   // Split the reached code into blocks; a block ends at a control transfer,
+   // before an instruction left to the interpreter, or where another block begins
+   struct Block {
+      size_t start, end;
+      std::vector<size_t> pcs;
+      uint8_t liveIn = 0, liveOut = FLAGS_ALL;
+   };
+   std::vector<Block> blocks;
+   std::vector<int> blockAt(size, -1);
+   for (size_t start = 0; start < size; start++) {
+      if (!leader[start] || !reached[start])
+         continue;
+
+      Block block;
+      block.start = start;
+      size_t pc = start;
+      for (;;) {
+         const uint8_t* code = &rom[pc];
+         block.pcs.push_back(pc);
+         pc += opcodes8080[*code].length;
+         if (flow(*code) != Flow::Next || pc >= size || leader[pc] || !reached[pc])
+            break;
+      }
+      block.end = pc;
+      blockAt[start] = (int)blocks.size();
+      blocks.push_back(std::move(block));
+   }
+   if (blocks.empty())
+      return std::string();
+
+   // Flag liveness, iterated to a fixed point across blocks. Flags leaving a block
+   // are live in any successor not known here: returns, PCHL, and code left to
+   // the interpreter. Successors are assumed to still hold their ROM bytes.
+   std::vector<Variant> variants;
+   auto liveIn = [&](const Block& block, uint8_t live, std::vector<Variant>* variants) {
+      for (size_t i = block.pcs.size(); i-- > 0;) {
+         uint8_t uses, defs;
+         bool removable;
+         flagEffects(rom[block.pcs[i]], uses, defs, removable);
+         if (variants != nullptr && eliminateDeadFlags && removable && defs != 0) {
+            if ((defs & live) == 0)
+               (*variants)[i] = Variant::NoFlags;
+            else if ((defs & live) == FLAG_Z && zeroVariant(rom[block.pcs[i]]))
+               (*variants)[i] = Variant::ZeroFlag;
+         }
+         live = (live & ~defs) | uses;
+      }
+      return live;
+   };
+   auto successorLive = [&](size_t address) -> uint8_t {
+      if (address >= size || blockAt[address] < 0)
+         return FLAGS_ALL;
+      return blocks[blockAt[address]].liveIn;
+   };
+
+   for (bool changed = eliminateDeadFlags; changed;) {
+      changed = false;
+      for (size_t b = blocks.size(); b-- > 0;) {
+         Block& block = blocks[b];
+         const uint8_t* last = &rom[block.pcs.back()];
+         switch (flow(*last)) {
+         case Flow::Next:   block.liveOut = successorLive(block.end); break;
+         case Flow::Jump:   block.liveOut = successorLive(target(last)); break;
+         case Flow::Branch: block.liveOut = successorLive(target(last)) | successorLive(block.end); break;
+         case Flow::Call:   block.liveOut = successorLive(target(last)) | (*last == 0xcd || (*last & 0xc7) == 0xc7 ? 0 : successorLive(block.end)); break;
+         default:           block.liveOut = FLAGS_ALL; break;
+         }
+
+         uint8_t live = liveIn(block, block.liveOut, nullptr);
+         if (live != block.liveIn) {
+            block.liveIn = live;
+            changed = true;
+         }
+      }
+   }
+
+   // One function per block
+   std::string table;
+   size_t instructions = 0, flagFree = 0, zeroOnly = 0;
+   for (const Block& block : blocks) {
+      unsigned cycles = 0;
+      variants.assign(block.pcs.size(), Variant::Flags);
+      liveIn(block, block.liveOut, &variants);
+
+      snprintf(text, sizeof(text), "\n   void block_%04zx(State8080& s) {\n", block.start);
+      out += text;
+      for (size_t i = 0; i < block.pcs.size(); i++) {
+         const uint8_t* code = &rom[block.pcs[i]];
+         comment(out, code, (uint16_t)block.pcs[i]);
+         statement(out, code, (uint16_t)(block.pcs[i] + opcodes8080[*code].length), variants[i]);
+         cycles += cycles8080[*code];
+         flagFree += variants[i] == Variant::NoFlags;
+         zeroOnly += variants[i] == Variant::ZeroFlag;
+      }
+      if (flow(rom[block.pcs.back()]) == Flow::Next) {
+         snprintf(text, sizeof(text), "      s.Reg.pc = 0x%04zx;\n", block.end & 0xffff);
+         out += text;
+      }
+      out += "   }\n";
+      instructions += block.pcs.size();
+
+      snprintf(text, sizeof(text), "      { 0x%04zx, 0x%04zx, %zu, %u, &rom[0x%04zx], block_%04zx },\n",
+         block.start, block.end - block.start, block.pcs.size(), cycles, block.start, block.start);
+      table += text;
+   }
+
+   out += "\n   const AotBlock8080 blocks[] = {\n";
+   out += table;
+   out += "   };\n\n";
+   out += "   const bool registered = Runtime8080::add(blocks, sizeof(blocks) / sizeof(blocks[0]));\n";
+   out += "}\n";
+
+   snprintf(text, sizeof(text), "// %zu blocks, %zu instructions, %zu without flag updates, %zu updating only Z\n",
+      blocks.size(), instructions, flagFree, zeroOnly);
+   out += text;
+   return out;
+}
+
+bool Recompile8080File(const char* rom, const char* source, bool eliminateDeadFlags) {
+   std::ifstream in(rom, std::ios::binary);
+   if (!in) return false;
+
+   in.seekg(0, std::ios::end);
+   std::vector<uint8_t> image((size_t)in.tellg());
+   in.seekg(0, std::ios::beg);
+   in.read((char*)image.data(), image.size());
+   in.close();
+
+   std::string text = Recompile8080(image.data(), image.size(), rom, eliminateDeadFlags);
+   if (text.empty()) return false;
+
+   std::ofstream out(source, std::ios::binary);
+   if (!out) return false;
+   out.write(text.data(), text.size());
+   out.close();
+
+   return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t
+#include <string>
+
+// Ahead-of-time translation of an 8080 ROM into C++ for Runtime8080.
+//
+// Code is found by recursive descent from the reset and RST vectors, following
+// jump and call targets and the fall-through of conditional branches and calls.
+// Every reached basic block becomes one function over State8080; anything not
+// reached (computed jumps through PCHL, data the walk never touches, undocumented
+// opcodes) is left to the interpreter at run time.
+//
+// Flag liveness runs over the blocks and their known successors. Instructions
+// whose flag results are overwritten before anything reads them are emitted as
+// Runtime8080::NoFlags variants, and those where only Z is read as ZeroFlag.
+
+// Translate rom (loaded at address 0) into a C++ source registering its blocks.
+// Returns an empty string if no code was found.
+std::string Recompile8080(const uint8_t* rom, size_t size, const char* name, bool eliminateDeadFlags = true);
+
+// Read a ROM image and write the generated source
+bool Recompile8080File(const char* rom, const char* source, bool eliminateDeadFlags = true);
@@ -0,0 +1,44 @@
+#include "Runtime8080.h"
+#include <cstring> // memcmp
+
+size_t Runtime8080::blockRuns = 0;
+size_t Runtime8080::interpretedSteps = 0;
+size_t Runtime8080::instructions = 0;
+
+namespace {
+   // Block starting at every address, or nullptr
+   // Function-local so registration from other translation units' static initializers is safe
+   const AotBlock8080** table() {
+      static const AotBlock8080* blocks[0x10000] = {};
+      return blocks;
+   }
+}
+
+bool Runtime8080::add(const AotBlock8080* blocks, size_t count) {
+   for (size_t i = 0; i < count; i++)
+      table()[blocks[i].address] = &blocks[i];
+   return true;
+}
+
+const AotBlock8080* Runtime8080::find(uint16_t address) {
+   return table()[address];
+}
+
+void Runtime8080::step(State8080& s) {
+   const AotBlock8080* block = find(s.Reg.pc);
+
+   // Pending interrupts, halts and code that no longer matches the ROM go through the interpreter
+   if (block != nullptr && !s.interruptRequested && !s.stopped
+      && (size_t)block->address + block->length <= sizeof(s.memory)
+      && memcmp(&s.memory[block->address], block->code, block->length) == 0) {
+      block->run(s);
+      s.cycles += block->cycles;
+      blockRuns++;
+      instructions += block->instructions;
+      return;
+   }
+
+   s.Emulate8080Op();
+   interpretedSteps++;
+   instructions++;
+}
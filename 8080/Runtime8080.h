@@ -0,0 +1,101 @@
+#pragma once
+#include "State8080.h"
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t
+
+// One basic block of a ROM translated ahead of time by Recompiler8080.
+// code points at the ROM bytes the block was translated from; the block is only
+// run while memory still holds those bytes, so patched or self-modified code
+// falls back to the interpreter.
+struct AotBlock8080 {
+   uint16_t address;
+   uint16_t length;
+   uint16_t instructions;
+   uint16_t cycles; // Conditional CALL/RET add their extra cycles when taken
+   const uint8_t* code;
+   void (*run)(State8080& s);
+};
+
+// Runtime for recompiled blocks. Blocks register themselves from a static
+// initializer in the generated source, and step() picks between a block and
+// Emulate8080Op for every dispatch. The static wrappers give generated code
+// the same helpers the interpreter uses, so both share one set of semantics.
+class Runtime8080 {
+public:
+   static bool add(const AotBlock8080* blocks, size_t count);
+   static const AotBlock8080* find(uint16_t address);
+
+   // Run one block, or one interpreted instruction if no valid block starts at pc
+   static void step(State8080& s);
+
+   static size_t blockRuns, interpretedSteps, instructions;
+
+   static void INR(State8080& s, uint8_t& x) { s.INR(x); }
+   static void DCR(State8080& s, uint8_t& x) { s.DCR(x); }
+   static void DAA(State8080& s) { s.DAA(); }
+   static void RLC(State8080& s) { s.RLC(); }
+   static void RRC(State8080& s) { s.RRC(); }
+   static void RAL(State8080& s) { s.RAL(); }
+   static void RAR(State8080& s) { s.RAR(); }
+
+   static void ADD(State8080& s, uint8_t value) { s.ADD(value); }
+   static void ADC(State8080& s, uint8_t value) { s.ADC(value); }
+   static void SUB(State8080& s, uint8_t value) { s.SUB(value); }
+   static void SBB(State8080& s, uint8_t value) { s.SBB(value); }
+   static void ANA(State8080& s, uint8_t value) { s.ANA(value); }
+   static void XRA(State8080& s, uint8_t value) { s.XRA(value); }
+   static void ORA(State8080& s, uint8_t value) { s.ORA(value); }
+   static void CMP(State8080& s, uint8_t value) { s.CMP(value); }
+
+   static void PUSH(State8080& s, uint16_t value) { s.PUSH(value); }
+   static uint16_t POP(State8080& s) { return s.POP(); }
+   static void PUSH_PSW(State8080& s) { s.PUSH_PSW(); }
+   static void POP_PSW(State8080& s) { s.POP_PSW(); }
+   static void DAD(State8080& s, uint32_t rp) { s.DAD(rp); }
+   static void CALL(State8080& s, uint16_t address) { s.CALL(address); }
+   static void RET(State8080& s) { s.RET(); }
+
+   // Variants for instructions whose flag results are all overwritten before
+   // anything reads them; only the register result is computed
+   struct NoFlags {
+      static void INR(State8080&, uint8_t& x) { x += 1; }
+      static void DCR(State8080&, uint8_t& x) { x -= 1; }
+      static void RLC(State8080& s) { s.Reg.a = (s.Reg.a << 1) | (s.Reg.a >> 7); }
+      static void RRC(State8080& s) { s.Reg.a = (s.Reg.a >> 1) | (s.Reg.a << 7); }
+      static void RAL(State8080& s) { s.Reg.a = (s.Reg.a << 1) | s.Reg.f.c; }
+      static void RAR(State8080& s) { s.Reg.a = (s.Reg.a >> 1) | (s.Reg.f.c << 7); }
+
+      static void ADD(State8080& s, uint8_t value) { s.Reg.a += value; }
+      static void ADC(State8080& s, uint8_t value) { s.Reg.a += value + s.Reg.f.c; }
+      static void SUB(State8080& s, uint8_t value) { s.Reg.a -= value; }
+      static void SBB(State8080& s, uint8_t value) { s.Reg.a -= value + s.Reg.f.c; }
+      static void ANA(State8080& s, uint8_t value) { s.Reg.a &= value; }
+      static void XRA(State8080& s, uint8_t value) { s.Reg.a ^= value; }
+      static void ORA(State8080& s, uint8_t value) { s.Reg.a |= value; }
+      static void CMP(State8080&, uint8_t) {}
+
+      static void DAD(State8080& s, uint32_t rp) { s.Reg.hl += rp; }
+   };
+
+   // Variants for instructions where Z is the only flag read before being
+   // overwritten, as in the DCR/JNZ and CPI/JNZ loop idioms
+   struct ZeroFlag {
+      static void INR(State8080& s, uint8_t& x) { s.Reg.f.z = (++x == 0); }
+      static void DCR(State8080& s, uint8_t& x) { s.Reg.f.z = (--x == 0); }
+
+      static void ADD(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a += value) == 0); }
+      static void ADC(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a += value + s.Reg.f.c) == 0); }
+      static void SUB(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a -= value) == 0); }
+      static void SBB(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a -= value + s.Reg.f.c) == 0); }
+      static void ANA(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a &= value) == 0); }
+      static void XRA(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a ^= value) == 0); }
+      static void ORA(State8080& s, uint8_t value) { s.Reg.f.z = ((s.Reg.a |= value) == 0); }
+      static void CMP(State8080& s, uint8_t value) { s.Reg.f.z = (s.Reg.a == value); }
+   };
+
+   static void IN(State8080& s, uint8_t port) { s.Reg.a = s.io.read(port); }
+   static void OUT(State8080& s, uint8_t port) { s.io.write(port, s.Reg.a); }
+   static void EI(State8080& s) { s.interrupt_enabled = true; }
+   static void DI(State8080& s) { s.interrupt_enabled = false; }
+   static void HLT(State8080& s) { s.stopped = true; }
+};
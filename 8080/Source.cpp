@@ -1,7 +1,13 @@
 #include "State8080.h"
 #include "IO.h"
+#include "Disassemble8080.h"
+#include "Invaders8080.h"
+#include "Recompiler8080.h"
+#include "Runtime8080.h"
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <string>
 #include <thread>
 #include <Windows.h>
 
@@ -44,22 +50,88 @@ void CPU_Cycles()
    {
       int pc = state->Reg.pc;
       state->Disassemble8080Op();
-      state->Emulate8080Op();
+      Runtime8080::step(*state); // Recompiled block if one is linked in, otherwise one instruction
       state->display();
    }
 
    std::cout << std::endl;
 }
 
+void Benchmark(const char* rom, size_t steps)
+{
+   std::ifstream file(rom, std::ios::binary);
+   file.read((char*)state->memory, sizeof(state->memory));
+   file.close();
+
+   auto start = std::chrono::steady_clock::now();
+   for (size_t i = 0; i < steps; i++)
+      Runtime8080::step(*state);
+   std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+   std::cout << Runtime8080::instructions << " instructions in " << seconds.count() << "s ("
+      << Runtime8080::instructions / seconds.count() / 1e6 << " MIPS), "
+      << Runtime8080::blockRuns << " blocks, "
+      << Runtime8080::interpretedSteps << " interpreted" << std::endl;
+}
+
+// Run the Invaders machine with and without idle loop skipping and compare the final state
+bool VerifyIdleSkip(const char* rom, uint64_t frames)
+{
+   uint64_t hashes[2];
+   for (int skip = 0; skip < 2; skip++) {
+      State8080* cpu = new State8080();
+      std::ifstream file(rom, std::ios::binary);
+      file.read((char*)cpu->memory, sizeof(cpu->memory));
+      file.close();
+
+      Invaders8080 machine(*cpu);
+      machine.skipIdleLoops = (skip == 1);
+
+      auto start = std::chrono::steady_clock::now();
+      machine.run(frames);
+      std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+      hashes[skip] = machine.hash();
+      std::cout << (skip ? "idle skip: " : "full:      ") << std::hex << hashes[skip] << std::dec << " "
+         << seconds.count() << "s, " << machine.idleCyclesSkipped << " of " << cpu->cycles
+         << " cycles skipped in " << machine.idleLoopsSkipped << " loops" << std::endl;
+      delete cpu;
+   }
+   return hashes[0] == hashes[1];
+}
+
 void init(char** argv)
 {
    std::ifstream file(argv[1], std::ios::binary);
-   file.read((char*)state->memory, 0xffff);
+   file.read((char*)state->memory, sizeof(state->memory));
    file.close();
 }
 
 int main(int argc, char** argv)
 {
+   // 8080 -d rom listing
+   // Disassemble the whole ROM image into a listing file
+   if (argc == 4 && std::string(argv[1]) == "-d")
+      return Disassemble8080File(argv[2], argv[3]) ? 0 : 1;
+
+   // 8080 -r rom source.cpp
+   // Translate the ROM into C++ blocks; add the output to the project to run them natively
+   // -rf keeps every flag update, to compare against dead-flag elimination
+   if (argc == 4 && (std::string(argv[1]) == "-r" || std::string(argv[1]) == "-rf"))
+      return Recompile8080File(argv[2], argv[3], std::string(argv[1]) == "-r") ? 0 : 1;
+
+   // 8080 -b rom steps
+   // Run headless without tracing and report throughput
+   if (argc == 4 && std::string(argv[1]) == "-b") {
+      Benchmark(argv[2], std::stoul(argv[3]));
+      return 0;
+   }
+
+   // 8080 -v rom frames
+   // Run headless with video interrupts and check idle loop skipping against full execution
+   if (argc == 4 && std::string(argv[1]) == "-v")
+      return VerifyIdleSkip(argv[2], std::stoull(argv[3])) ? 0 : 1;
+
    if (argc != 2)
       return 0;
 
@@ -1,6 +1,9 @@
 #pragma once
 #include "IO.h"
+#include <array>
+#include <cstddef> // size_t
 #include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <utility> // std::index_sequence
 
 #define SET 1
 #define RESET 0
@@ -31,15 +34,33 @@ public:
          uint8_t z; // Zero
          uint8_t s; // Sign
       }f = { RESET, RESET, RESET, RESET, RESET };
-      union { uint16_t bc = 0; struct { uint8_t b, c; }; };
-      union { uint16_t de = 0; struct { uint8_t d, e; }; };
-      union { uint16_t hl = 0; struct { uint8_t h, l; }; };
+      // Register file, laid out so each pair reads as one little-endian word
+      // (B is the high byte of BC, C the low byte)
+      union {
+         uint8_t r[6] = {}; // Indexed through registerIndex
+         struct { uint8_t c, b, e, d, l, h; };
+         struct { uint16_t bc, de, hl; };
+      };
       uint16_t pc = 0, sp = 0;
    } Reg;
 
-   uint8_t memory[0xffff] = {};
+   uint8_t memory[0x10000] = {};
+   uint64_t cycles = 0; // Clock cycles executed, see cycles8080
    template<typename T> T& mem(int address) {
-      return *(*T)(&memory[address]);
+      return *(T*)(&memory[address]);
+   }
+
+   // Register by its 3 bit DDD/SSS code from the instruction
+   //    000 B, 001 C, 010 D, 011 E, 100 H, 101 L, 110 M, 111 A
+   // M is the byte at HL and A lives in the PSW pair, so neither goes through Reg.r
+   static constexpr uint8_t registerIndex[8] = { 1, 0, 3, 2, 5, 4, 0, 0 };
+   template<int CODE> uint8_t& reg() {
+      if constexpr (CODE == 6)
+         return mem<uint8_t>(Reg.hl);
+      else if constexpr (CODE == 7)
+         return Reg.a;
+      else
+         return Reg.r[registerIndex[CODE]];
    }
 
    void Emulate8080Op();
@@ -56,6 +77,8 @@ public:
    void generateInterrupt(uint8_t opcode);
 
 private:
+   friend class Runtime8080; // Recompiled blocks call the same helpers as the interpreter
+
    IO io;
    bool interrupt_enabled = false;  // Are we ready to take interrupts?
    bool interruptRequested = false; // Is there an interrupt now?
@@ -67,6 +90,11 @@ private:
 
    void DAA();
 
+   void RLC();
+   void RRC();
+   void RAL();
+   void RAR();
+
    void ADD(uint8_t value);
    void ADC(uint8_t value);
    void SUB(uint8_t value);
@@ -76,8 +104,33 @@ private:
    void ORA(uint8_t value);
    void CMP(uint8_t value);
 
+   // MOV DDD,SSS and ADD/ADC/SUB/SBB/ANA/XRA/ORA/CMP SSS for every register code,
+   // one handler per opcode 0x40-0xBF (0x76 is HLT and never dispatched here)
+   using Handler = void (State8080::*)();
+   static const std::array<Handler, 0x80> blockHandlers;
+   template<int OPCODE> static constexpr Handler blockHandler();
+   template<size_t... I> static constexpr std::array<Handler, sizeof...(I)> makeBlockHandlers(std::index_sequence<I...>);
+
+   template<int DDD, int SSS> void MOV() {
+      reg<DDD>() = reg<SSS>();
+   }
+
+   template<int OP, int SSS> void ALU() {
+      uint8_t value = reg<SSS>();
+      if constexpr (OP == 0) ADD(value);
+      else if constexpr (OP == 1) ADC(value);
+      else if constexpr (OP == 2) SUB(value);
+      else if constexpr (OP == 3) SBB(value);
+      else if constexpr (OP == 4) ANA(value);
+      else if constexpr (OP == 5) XRA(value);
+      else if constexpr (OP == 6) ORA(value);
+      else CMP(value);
+   }
+
    void PUSH(uint16_t val);
    uint16_t POP();
+   void PUSH_PSW();
+   void POP_PSW();
 
    void DAD(uint32_t rp);
 
@@ -0,0 +1,33 @@
+#include "Checkpoints.h"
+
+int Checkpoints::save() {
+   Checkpoint checkpoint;
+   checkpoint.cpu = cpu.state();
+   if (current >= 0)
+      checkpoint.pages = checkpoints[current].pages;
+   for (int page = 0; page < Memory::PAGES; page++)
+      if (current < 0 || memory.dirty(page)) {
+         auto copy = std::make_shared<std::array<byte, 1 << Memory::PAGE_BITS>>();
+         memcpy(copy->data(), &memory.data()[page << Memory::PAGE_BITS], copy->size());
+         checkpoint.pages[page] = std::move(copy);
+         saved++;
+      }
+   memory.clearDirty();
+   checkpoints.push_back(std::move(checkpoint));
+   return current = (int)checkpoints.size() - 1;
+}
+
+void Checkpoints::restore(int checkpoint) {
+   const Checkpoint& to = checkpoints.at(checkpoint);
+   const Checkpoint& from = checkpoints[current];
+   for (int page = 0; page < Memory::PAGES; page++)
+      if (memory.dirty(page) || to.pages[page] != from.pages[page]) {
+         memcpy(&memory.data()[page << Memory::PAGE_BITS], to.pages[page]->data(), to.pages[page]->size());
+         // Decoded code, the mirror, and the display's cells when the page is in a video buffer
+         memory.written(page << Memory::PAGE_BITS, 1 << Memory::PAGE_BITS);
+         restored++;
+      }
+   memory.clearDirty();
+   cpu.restore(to.cpu);
+   current = checkpoint;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Common.h"
+#include "I8086.h"
+#include "Memory.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+// Checkpoints of a processor and its memory, taken between calls to run() and restored in any order.
+// The first checkpoint copies every page; each one after copies only the pages Memory marked dirty since
+// the last checkpoint or restore, and shares the rest with the checkpoint before it. Restoring copies back
+// only the pages that differ: those dirty since then, and those whose saved copies differ between the two
+// checkpoints. What devices keep outside memory is not saved (see I8086::State).
+class Checkpoints {
+public:
+   Checkpoints(I8086& cpu, Memory& memory) : cpu(cpu), memory(memory) {}
+
+   int save(); // Returns the checkpoint's number, counting from 0
+   void restore(int checkpoint);
+
+   int size() const { return (int)checkpoints.size(); }
+   int pagesSaved() const { return saved; } // copies made, over all checkpoints
+   int pagesRestored() const { return restored; } // copies written back, over all restores
+private:
+   typedef std::shared_ptr<const std::array<byte, 1 << Memory::PAGE_BITS>> Page;
+   struct Checkpoint {
+      I8086::State cpu;
+      std::array<Page, Memory::PAGES> pages;
+   };
+
+   I8086& cpu;
+   Memory& memory;
+   std::vector<Checkpoint> checkpoints;
+   int current = -1; // the checkpoint memory was last saved at or restored to: the pages not dirty are its
+   int saved = 0, restored = 0;
+};
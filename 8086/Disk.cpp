@@ -0,0 +1,84 @@
+#include "Disk.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Disk::Disk(std::string path, byte drive) : number(drive) {
+#if defined(_WIN32)
+   file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file == INVALID_HANDLE_VALUE) {
+      file = nullptr;
+      return;
+   }
+   LARGE_INTEGER length;
+   if (!GetFileSizeEx(file, &length) || length.QuadPart < SECTOR)
+      return;
+   // PAGE_WRITECOPY/FILE_MAP_COPY: written pages are copied privately and never reach the file
+   mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+   if (!mapping)
+      return;
+   image = (byte*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+   size = (size_t)length.QuadPart;
+#else
+   int fd = open(path.c_str(), O_RDONLY);
+   if (fd < 0)
+      return;
+   struct stat status;
+   if (fstat(fd, &status) == 0 && status.st_size >= SECTOR) {
+      // MAP_PRIVATE: written pages are copied privately and never reach the file
+      void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (view != MAP_FAILED) {
+         image = (byte*)view;
+         size = (size_t)status.st_size;
+      }
+   }
+   close(fd); // the mapping keeps the file open
+#endif
+   if (!image) {
+      size = 0;
+      return;
+   }
+
+   // Floppy formats by size in KB (cylinders, heads, sectors per track)
+   struct Format { int kilobytes, cylinders, heads, sectors; };
+   const Format formats[] = {
+      { 160, 40, 1, 8 }, { 180, 40, 1, 9 }, { 320, 40, 2, 8 }, { 360, 40, 2, 9 },
+      { 720, 80, 2, 9 }, { 1200, 80, 2, 15 }, { 1440, 80, 2, 18 }, { 2880, 80, 2, 36 }
+   };
+   for (const Format& format : formats)
+      if (size == (size_t)format.kilobytes * 1024) {
+         tracks = format.cylinders;
+         sides = format.heads;
+         perTrack = format.sectors;
+      }
+   if (!tracks) { // hard disk
+      sides = 16;
+      perTrack = 63;
+      tracks = (int)(size / SECTOR / (sides * perTrack));
+      if (tracks > 1024) tracks = 1024; // all that INT 13h can address
+      if (tracks == 0) tracks = 1;
+   }
+}
+
+Disk::~Disk() {
+#if defined(_WIN32)
+   if (image) UnmapViewOfFile(image);
+   if (mapping) CloseHandle(mapping);
+   if (file) CloseHandle(file);
+#else
+   if (image) munmap(image, size);
+#endif
+}
+
+int Disk::lba(int cylinder, int head, int sector) const {
+   if (cylinder >= tracks || head >= sides || sector < 1 || sector > perTrack)
+      return -1;
+   return (cylinder * sides + head) * perTrack + sector - 1;
+}
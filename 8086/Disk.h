@@ -0,0 +1,41 @@
+#pragma once
+#include "Common.h"
+#include <string>
+
+// A floppy or hard disk backed by an image file.
+// The file is mapped copy-on-write: sectors are read straight from the mapping, and written sectors
+// become private pages of this process, so the image file itself is never changed.
+class Disk {
+public:
+   static constexpr int SECTOR = 512;
+
+   // drive is the BIOS drive number: 0x00-0x7F floppies, 0x80 and up hard disks
+   Disk(std::string file, byte drive);
+   ~Disk();
+
+   bool mapped() const { return image != nullptr; }
+   byte drive() const { return number; }
+   bool floppy() const { return number < 0x80; }
+
+   // Geometry guessed from the image size (standard floppy formats, otherwise 16 heads of 63 sectors)
+   int cylinders() const { return tracks; }
+   int heads() const { return sides; }
+   int sectorsPerTrack() const { return perTrack; }
+   int sectors() const { return (int)(size / SECTOR); }
+
+   // Sector lba, or nullptr past the end of the image
+   byte* sector(int lba) { return lba >= 0 && lba < sectors() ? image + (size_t)lba * SECTOR : nullptr; }
+   // CHS (cylinder, head, 1-based sector) to LBA, -1 if outside the geometry
+   int lba(int cylinder, int head, int sector) const;
+
+private:
+   byte number;
+   byte* image = nullptr;
+   size_t size = 0;
+   int tracks = 0, sides = 0, perTrack = 0;
+
+#if defined(_WIN32)
+   void* file = nullptr;
+   void* mapping = nullptr;
+#endif
+};
@@ -0,0 +1,203 @@
+#include "Display.h"
+#include <cstring>
+#include <string>
+
+namespace {
+   // 6845 registers R0-R15 as the BIOS sets them for 80x25 text (IBM PC Technical Reference, VIDEO_PARMS)
+   constexpr byte TEXT_80X25[16] = { 0x71, 0x50, 0x5A, 0x0A, 0x1F, 0x06, 0x19, 0x1C, 0x02, 0x07, 0x06, 0x07, 0, 0, 0, 0 };
+   constexpr byte MONOCHROME[16] = { 0x61, 0x50, 0x52, 0x0F, 0x19, 0x06, 0x19, 0x19, 0x02, 0x0D, 0x0B, 0x0C, 0, 0, 0, 0 };
+
+   // CGA raster in processor clocks (3 per dot of the 14.318 MHz dot clock): lines of 912 dots of which 640
+   // are displayed, 262 lines a frame of which 200 are displayed, vertical sync from line 224 for 16 lines
+   constexpr int LINE = 304, LINE_DISPLAYED = 213;
+   constexpr int FRAME_LINES = 262, LINES_DISPLAYED = 200, VSYNC = 224, VSYNC_LINES = 16;
+   constexpr int MDA_CELLS = Display::CGA_SIZE / 2; // index of the first MDA cell in marked
+
+   // Code page 437, the characters of the adapters' ROM, as Unicode
+   constexpr char16_t CP437[256] = {
+      0x0020, 0x263A, 0x263B, 0x2665, 0x2666, 0x2663, 0x2660, 0x2022, 0x25D8, 0x25CB, 0x25D9, 0x2642, 0x2640, 0x266A, 0x266B, 0x263C,
+      0x25BA, 0x25C4, 0x2195, 0x203C, 0x00B6, 0x00A7, 0x25AC, 0x21A8, 0x2191, 0x2193, 0x2192, 0x2190, 0x221F, 0x2194, 0x25B2, 0x25BC,
+      0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+      0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+      0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+      0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F,
+      0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+      0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, 0x0078, 0x0079, 0x007A, 0x007B, 0x007C, 0x007D, 0x007E, 0x2302,
+      0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7, 0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+      0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9, 0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,
+      0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA, 0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+      0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556, 0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+      0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F, 0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+      0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B, 0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+      0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4, 0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,
+      0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248, 0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0,
+   };
+
+   void appendUtf8(std::string& text, byte character) {
+      const char16_t code = CP437[character];
+      if (code < 0x80) {
+         text += (char)code;
+      } else if (code < 0x800) {
+         text += (char)(0xC0 | code >> 6);
+         text += (char)(0x80 | (code & 0x3F));
+      } else {
+         text += (char)(0xE0 | code >> 12);
+         text += (char)(0x80 | (code >> 6 & 0x3F));
+         text += (char)(0x80 | (code & 0x3F));
+      }
+   }
+
+   // Select Graphic Rendition for an attribute. CGA: bits 0-3 foreground with intensity, 4-6 background,
+   // 7 blink. MDA: underline (foreground 1 on black), reverse (70h), invisible (black on black), intensity, blink
+   void appendAttribute(std::string& text, byte attribute, bool mda) {
+      static constexpr int ANSI[8] = { 0, 4, 2, 6, 1, 5, 3, 7 }; // IRGB order to ANSI's BGR
+      text += "\x1b[0";
+      if (mda) {
+         if (attribute & 0x08) text += ";1";
+         if ((attribute & 0x77) == 0x01) text += ";4";
+         if ((attribute & 0x77) == 0x70) text += ";7";
+         if ((attribute & 0x77) == 0x00) text += ";8";
+      } else {
+         text += ";" + std::to_string((attribute & 0x08 ? 90 : 30) + ANSI[attribute & 7]);
+         text += ";" + std::to_string(40 + ANSI[attribute >> 4 & 7]);
+      }
+      if (attribute & 0x80) text += ";5";
+      text += "m";
+   }
+}
+
+Display::Display(Memory& memory, const unsigned long long& clock) : memory(memory), clock(clock),
+   mode(0x29), marked(MDA_CELLS + MDA_SIZE / 2) {
+   memcpy(registers[0], TEXT_80X25, sizeof TEXT_80X25);
+   memcpy(registers[1], MONOCHROME, sizeof MONOCHROME);
+}
+
+word Display::cell(int row, int column) const {
+   const int offset = ((startAddress() + row * columns() + column) & (bufferCells() - 1)) * 2;
+   word value;
+   memcpy(&value, &memory.data()[buffer() + offset], sizeof value);
+   return value;
+}
+
+int Display::cursor() const {
+   if ((crtc()[CURSOR_START] & 0x60) == 0x20)
+      return -1;
+   const int address = crtc()[CURSOR_ADDRESS] << 8 | crtc()[CURSOR_ADDRESS + 1];
+   const int index = (address - startAddress()) & (bufferCells() - 1);
+   return index < rows() * columns() ? index : -1;
+}
+
+int Display::update(const Draw& draw) {
+   const Layout now = layout();
+   int count = 0;
+   if (redraw || now != shown) {
+      if (now.text)
+         for (int row = 0; row < now.rows; row++)
+            for (int column = 0; column < now.columns; column++, count++)
+               draw(row, column, cell(row, column));
+   } else if (now.text) {
+      // The cells of the buffer shown, and which of them are on the screen
+      const int first = mda ? MDA_CELLS : 0, cells = bufferCells(), screen = now.rows * now.columns;
+      for (const int change : changes) {
+         const int index = (change - first - now.start) & (cells - 1);
+         if (change < first || change >= first + cells || index >= screen)
+            continue;
+         draw(index / now.columns, index % now.columns, cell(index / now.columns, index % now.columns));
+         count++;
+      }
+   }
+   for (const int change : changes)
+      marked[change] = false;
+   changes.clear();
+   shown = now;
+   redraw = false;
+   return count;
+}
+
+int Display::render(std::ostream& out) {
+   std::string output;
+   if (redraw || layout() != shown)
+      output += "\x1b[0m\x1b[2J";
+   int row = -1, column = -1, attribute = -1;
+   const int drawn = update([&](int r, int c, word cell) {
+      if (r != row || c != column)
+         output += "\x1b[" + std::to_string(r + 1) + ";" + std::to_string(c + 1) + "H";
+      if ((cell >> 8) != attribute) {
+         attribute = cell >> 8;
+         appendAttribute(output, (byte)attribute, mda);
+      }
+      appendUtf8(output, (byte)cell);
+      row = r;
+      column = c + 1;
+   });
+   if (drawn)
+      output += "\x1b[0m";
+   const int at = cursor();
+   if (!output.empty() || at != shownCursor) { // drawing moved the terminal's cursor
+      if (at < 0)
+         output += "\x1b[?25l";
+      else
+         output += "\x1b[" + std::to_string(at / columns() + 1) + ";" + std::to_string(at % columns() + 1) + "H\x1b[?25h";
+      shownCursor = at;
+   }
+   out << output << std::flush;
+   return drawn;
+}
+
+void Display::snapshot(std::ostream& out) const {
+   if (!text())
+      return;
+   for (int row = 0; row < rows(); row++) {
+      int length = columns();
+      while (length > 0 && ((byte)cell(row, length - 1) == ' ' || (byte)cell(row, length - 1) == 0))
+         length--;
+      std::string line;
+      for (int column = 0; column < length; column++)
+         appendUtf8(line, (byte)cell(row, column));
+      out << line << '\n';
+   }
+}
+
+void Display::written(int address, int length) {
+   for (int at = address & ~1; at < address + length; at += 2) {
+      const int change = at >= CGA_BUFFER ? (at - CGA_BUFFER) >> 1 : MDA_CELLS + ((at - MDA_BUFFER) >> 1);
+      if (!marked[change]) {
+         marked[change] = true;
+         changes.push_back(change);
+      }
+   }
+}
+
+// Ports 3x0h-3x7h select (even) and access (odd) a 6845 register, 3x8h is the mode control register and
+// 3xAh the status register, x being B for the MDA and D for the CGA
+byte Display::in(word port) {
+   const int adapter = (port & 0xFFF0) == 0x3B0;
+   const int number = port & 0x0F;
+   if (number < 8 && (number & 1)) // only the cursor address and light pen registers read back
+      return index[adapter] >= CURSOR_ADDRESS && index[adapter] < REGISTERS ? registers[adapter][index[adapter]] : 0;
+   if (number == 0x0A) {
+      // Status: bit 0 the display is not showing (retrace, or the MDA's horizontal sync), bit 3 vertical sync
+      const unsigned long long frame = clock % (LINE * FRAME_LINES);
+      const int line = (int)(frame / LINE), dot = (int)(frame % LINE);
+      byte status = dot >= LINE_DISPLAYED || (!adapter && line >= LINES_DISPLAYED) ? 0x01 : 0;
+      if (!adapter && line >= VSYNC && line < VSYNC + VSYNC_LINES)
+         status |= 0x08;
+      return status;
+   }
+   return 0xFF;
+}
+
+void Display::out(word port, byte value) {
+   const int adapter = (port & 0xFFF0) == 0x3B0;
+   const int number = port & 0x0F;
+   if (number < 8) {
+      if (!(number & 1))
+         index[adapter] = value & 0x1F;
+      else if (index[adapter] < REGISTERS)
+         registers[adapter][index[adapter]] = value;
+   } else if (number == 0x08) { // mode control: the adapter written is shown
+      mda = adapter;
+      if (!adapter)
+         mode = value;
+   }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Common.h"
+#include "IO.h"
+#include "Memory.h"
+
+#include <functional>
+#include <ostream>
+#include <vector>
+
+// Text modes of the Monochrome Display Adapter (buffer B000:0000, ports 3B0h-3BFh) and the Color Graphics
+// Adapter (B800:0000, ports 3D0h-3DFh), as if both were fitted. The adapter shown is the one whose mode
+// control register was written last; the 6845 CRT controller registers give the size of the screen,
+// the address it starts at and the cursor.
+// The buffers are watched pages (Memory::PageType::WATCHED): read and written in place like RAM, block
+// operations included, with the bytes changed passed to written(), which notes their cells, so update()
+// only visits the cells changed since it last ran.
+// Graphics modes are not displayed.
+class Display : public MemoryDevice, public IODevice {
+public:
+   static constexpr int MDA_BUFFER = 0xB'0000, MDA_SIZE = 0x1000;
+   static constexpr int CGA_BUFFER = 0xB'8000, CGA_SIZE = 0x4000;
+
+   // memory holds the buffers; clock is the processor's, for the status register's retrace bits
+   Display(Memory& memory, const unsigned long long& clock);
+
+   bool monochrome() const { return mda; }
+   bool text() const { return mda || !(mode & GRAPHICS); }
+   int columns() const { return crtc()[HORIZONTAL_DISPLAYED]; }
+   int rows() const { return crtc()[VERTICAL_DISPLAYED]; }
+   // Character (low byte) and attribute (high byte) of a cell on the screen
+   word cell(int row, int column) const;
+   // Cell index (row * columns() + column) of the cursor, -1 if it is off or not on the screen
+   int cursor() const;
+
+   // Call draw for each cell on the screen written since the last update(), or for all of them after
+   // invalidate() and after the adapter, its start address or its size changed. Returns the cells drawn
+   typedef std::function<void(int row, int column, word cell)> Draw;
+   int update(const Draw& draw);
+   void invalidate() { redraw = true; }
+
+   // update() to a terminal: the changed cells as ANSI escape sequences, characters as UTF-8, then the cursor
+   int render(std::ostream& out);
+   // The screen as UTF-8 text, a line per row without trailing blanks
+   void snapshot(std::ostream& out) const;
+
+   void written(int address, int length) override;
+   byte in(word port) override;
+   void out(word port, byte value) override;
+private:
+   // 6845 registers used (IBM PC Technical Reference, 6845 CRT controller)
+   enum {
+      HORIZONTAL_DISPLAYED = 1,
+      VERTICAL_DISPLAYED = 6,
+      CURSOR_START = 10, // bits 6-5: 01 is no cursor
+      CURSOR_END = 11,
+      START_ADDRESS = 12, // high, then low: character offset of the screen in the buffer
+      CURSOR_ADDRESS = 14,
+      REGISTERS = 18
+   };
+   enum : byte { GRAPHICS = 0x02 }; // CGA mode control
+
+   const byte* crtc() const { return registers[mda]; } // of the adapter shown
+   int buffer() const { return mda ? MDA_BUFFER : CGA_BUFFER; }
+   int bufferCells() const { return (mda ? MDA_SIZE : CGA_SIZE) / 2; }
+   int startAddress() const { return crtc()[START_ADDRESS] << 8 | crtc()[START_ADDRESS + 1]; }
+   // What update() last drew the screen from; a change to it draws every cell
+   struct Layout {
+      bool mda, text;
+      int columns, rows, start;
+      bool operator!=(const Layout& other) const {
+         return mda != other.mda || text != other.text || columns != other.columns || rows != other.rows || start != other.start;
+      }
+   };
+   Layout layout() const { return { mda, text(), columns(), rows(), startAddress() }; }
+
+   Memory& memory;
+   const unsigned long long& clock;
+   byte registers[2][REGISTERS] = {}; // 6845 of the CGA, of the MDA
+   byte index[2] = {};                // register selected at port 3x4h
+   byte mode;                         // CGA mode control, port 3D8h
+   bool mda = false;
+
+   // Cells written (buffer offset / 2, MDA cells after the CGA's) not yet seen by update(), each once
+   std::vector<bool> marked;
+   std::vector<int> changes;
+   Layout shown{};
+   bool redraw = true;
+   int shownCursor = -1; // where render() last put the cursor
+};
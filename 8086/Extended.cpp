@@ -0,0 +1,592 @@
+#include "Extended.h"
+#include <cstring>
+
+namespace {
+   typedef Arithmetic<Extended> A;
+
+   constexpr int BIAS = 16383;
+   constexpr int MAX_EXPONENT = 0x7FFF;
+   constexpr uint64_t INTEGER_BIT = 1ull << 63;
+   constexpr uint64_t QUIET_BIT = 1ull << 62;
+
+   int biased(Extended a) { return a.exponent & 0x7FFF; }
+   bool isNaN(Extended a) { return biased(a) == MAX_EXPONENT && (a.significand << 1) != 0; }
+   bool isInfinity(Extended a) { return biased(a) == MAX_EXPONENT && (a.significand << 1) == 0; }
+   Extended make(bool sign, int exponent, uint64_t significand) { return { significand, (word)(sign << 15 | exponent) }; }
+   Extended zero(bool sign) { return make(sign, 0, 0); }
+   Extended infinity(bool sign) { return make(sign, MAX_EXPONENT, INTEGER_BIT); }
+
+   int leadingZeros(uint64_t x) {
+      if (!x) return 64;
+      int n = 0;
+      for (int shift = 32; shift; shift >>= 1)
+         if (!(x >> (64 - shift))) {
+            x <<= shift;
+            n += shift;
+         }
+      return n;
+   }
+
+   // sign * magnitude, exactly
+   Extended integer(bool sign, uint64_t magnitude) {
+      if (magnitude == 0)
+         return zero(sign);
+      const int n = leadingZeros(magnitude);
+      return make(sign, BIAS + 63 - n, magnitude << n);
+   }
+
+   // hi:lo = a * b
+   void multiply64(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+      const uint64_t a0 = (uint32_t)a, a1 = a >> 32, b0 = (uint32_t)b, b1 = b >> 32;
+      const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+      const uint64_t middle = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+      lo = middle << 32 | (uint32_t)p00;
+      hi = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+   }
+
+   // Shift hi:lo right by n bits; bits shifted out are kept as a 1 in the lowest bit (sticky), which is all
+   // rounding needs of them
+   void shiftRight(uint64_t& hi, uint64_t& lo, int n) {
+      if (n <= 0)
+         return;
+      if (n >= 128) {
+         lo = (hi | lo) != 0;
+         hi = 0;
+      } else if (n >= 64) {
+         const bool sticky = lo != 0 || (n > 64 && (hi << (128 - n)) != 0);
+         lo = hi >> (n - 64) | sticky;
+         hi = 0;
+      } else {
+         const bool sticky = (lo << (64 - n)) != 0;
+         lo = lo >> n | hi << (64 - n) | sticky;
+         hi >>= n;
+      }
+   }
+
+   // A finite nonzero value (hi + lo / 2^64) * 2^(exponent - 63): hi has the integer bit when normalized
+   struct Unpacked {
+      bool sign;
+      int exponent;
+      uint64_t hi, lo;
+   };
+
+   Unpacked unpack(Extended a) {
+      // A denormal has the exponent of the smallest normal without the integer bit
+      return { A::negative(a), (biased(a) ? biased(a) : 1) - BIAS, a.significand, 0 };
+   }
+
+   void normalize(Unpacked& u) {
+      if (u.hi == 0) {
+         u.hi = u.lo;
+         u.lo = 0;
+         u.exponent -= 64;
+      }
+      const int n = leadingZeros(u.hi);
+      if (n) {
+         u.hi = u.hi << n | u.lo >> (64 - n);
+         u.lo <<= n;
+         u.exponent -= n;
+      }
+   }
+
+   // Round u to precision significand bits for a format whose normal numbers have exponents minimum to
+   // maximum. The significand keeps its integer bit at bit 63; it is clear for a denormal (or zero) result,
+   // whose exponent is minimum
+   struct Rounded {
+      int exponent;
+      uint64_t significand;
+      bool infinity;
+   };
+   Rounded round(Unpacked u, int precision, int minimum, int maximum, FloatEnvironment& environment) {
+      if (u.hi == 0 && u.lo == 0)
+         return { minimum, 0, false };
+      normalize(u);
+      const bool tiny = u.exponent < minimum;
+      if (tiny) {
+         shiftRight(u.hi, u.lo, u.exponent < minimum - 200 ? 200 : minimum - u.exponent);
+         u.exponent = minimum;
+      }
+
+      const int discarded = 64 - precision;
+      bool half, sticky, odd;
+      if (discarded == 0) {
+         half = u.lo >> 63;
+         sticky = (u.lo << 1) != 0;
+         odd = u.hi & 1;
+      } else {
+         half = u.hi >> (discarded - 1) & 1;
+         sticky = (u.hi & ((1ull << (discarded - 1)) - 1)) != 0 || u.lo != 0;
+         odd = u.hi >> discarded & 1;
+         u.hi &= ~((1ull << discarded) - 1);
+      }
+      const bool inexact = half || sticky;
+      bool up = false;
+      switch (environment.rounding) {
+      case Rounding::Nearest: up = half && (sticky || odd); break;
+      case Rounding::Down:    up = inexact && u.sign; break;
+      case Rounding::Up:      up = inexact && !u.sign; break;
+      case Rounding::Chop:    break;
+      }
+      if (inexact) {
+         environment.exceptions |= Exception::Precision;
+         if (tiny)
+            environment.exceptions |= Exception::Underflow;
+      }
+      if (up) {
+         const uint64_t unit = 1ull << discarded;
+         u.hi += unit;
+         if (u.hi < unit) { // carried out of the significand
+            u.hi = INTEGER_BIT;
+            u.exponent++;
+         }
+      }
+
+      if (u.exponent > maximum) {
+         environment.exceptions |= Exception::Overflow | Exception::Precision;
+         const bool toInfinity = environment.rounding == Rounding::Nearest
+            || (environment.rounding == Rounding::Up && !u.sign) || (environment.rounding == Rounding::Down && u.sign);
+         if (toInfinity)
+            return { maximum + 1, 0, true };
+         return { maximum, ~0ull << discarded, false }; // the largest finite
+      }
+      return { u.exponent, u.hi, false };
+   }
+
+   Extended pack(bool sign, Rounded r) {
+      if (r.infinity)
+         return infinity(sign);
+      return make(sign, r.significand & INTEGER_BIT ? r.exponent + BIAS : 0, r.significand);
+   }
+
+   // Round to the precision control in the temporary real's exponent range
+   Extended result(Unpacked u, FloatEnvironment& environment) {
+      return pack(u.sign, round(u, environment.precision, 1 - BIAS, MAX_EXPONENT - 1 - BIAS, environment));
+   }
+
+   // The result of an operation on a NaN: the NaN (the larger if both are), quiet; signaling NaNs are invalid
+   Extended propagate(Extended a, Extended b, FloatEnvironment& environment) {
+      if ((isNaN(a) && !(a.significand & QUIET_BIT)) || (isNaN(b) && !(b.significand & QUIET_BIT)))
+         environment.exceptions |= Exception::Invalid;
+      Extended nan = !isNaN(b) || (isNaN(a) && a.significand >= b.significand) ? a : b;
+      nan.significand |= QUIET_BIT;
+      return nan;
+   }
+
+   Extended invalid(FloatEnvironment& environment) {
+      environment.exceptions |= Exception::Invalid;
+      return A::indefinite();
+   }
+
+   void checkDenormal(Extended a, FloatEnvironment& environment) {
+      if (biased(a) == 0 && a.significand != 0)
+         environment.exceptions |= Exception::Denormal;
+   }
+
+   // The integer part of |a| and what rounding it by the environment adds: 0 or 1
+   uint64_t integerPart(Extended a, FloatEnvironment& environment) {
+      Unpacked u = unpack(a);
+      const int fraction = 63 - u.exponent; // bits below the binary point
+      if (fraction <= 0)
+         return u.hi << -fraction;
+      uint64_t hi = u.hi, lo = 0;
+      shiftRight(hi, lo, fraction);
+      const bool half = lo >> 63, sticky = (lo << 1) != 0;
+      if (half || sticky)
+         environment.exceptions |= Exception::Precision;
+      bool up = false;
+      switch (environment.rounding) {
+      case Rounding::Nearest: up = half && (sticky || (hi & 1)); break;
+      case Rounding::Down:    up = (half || sticky) && u.sign; break;
+      case Rounding::Up:      up = (half || sticky) && !u.sign; break;
+      case Rounding::Chop:    break;
+      }
+      return hi + up;
+   }
+
+   // Short or long real to temporary real
+   Extended widen(uint64_t bits, int exponentBits, int fractionBits, FloatEnvironment& environment) {
+      const bool sign = bits >> (exponentBits + fractionBits) & 1;
+      const int exponent = (int)(bits >> fractionBits) & ((1 << exponentBits) - 1);
+      const uint64_t fraction = bits & ((1ull << fractionBits) - 1);
+      const int bias = (1 << (exponentBits - 1)) - 1;
+      const uint64_t significand = fraction << (63 - fractionBits);
+      if (exponent == (1 << exponentBits) - 1) {
+         if (fraction == 0)
+            return infinity(sign);
+         if (!(significand & QUIET_BIT))
+            environment.exceptions |= Exception::Invalid;
+         return make(sign, MAX_EXPONENT, INTEGER_BIT | QUIET_BIT | significand);
+      }
+      if (exponent == 0) {
+         if (fraction == 0)
+            return zero(sign);
+         environment.exceptions |= Exception::Denormal;
+         FloatEnvironment exact;
+         return result({ sign, 1 - bias, significand, 0 }, exact);
+      }
+      return make(sign, exponent - bias + BIAS, INTEGER_BIT | significand);
+   }
+
+   // Temporary real to short or long real, rounded by the environment's rounding control
+   uint64_t narrow(Extended a, int exponentBits, int fractionBits, FloatEnvironment& environment) {
+      const uint64_t sign = (uint64_t)A::negative(a) << (exponentBits + fractionBits);
+      const uint64_t maximum = (1ull << exponentBits) - 1;
+      const int bias = (1 << (exponentBits - 1)) - 1;
+      if (isNaN(a))
+         return sign | maximum << fractionBits | 1ull << (fractionBits - 1) | (a.significand << 1) >> (64 - fractionBits);
+      if (isInfinity(a))
+         return sign | maximum << fractionBits;
+      if (a.significand == 0)
+         return sign;
+      checkDenormal(a, environment);
+      const Rounded r = round(unpack(a), fractionBits + 1, 1 - bias, bias, environment);
+      if (r.infinity)
+         return sign | maximum << fractionBits;
+      const uint64_t exponent = r.significand & INTEGER_BIT ? r.exponent + bias : 0;
+      return sign | exponent << fractionBits | (r.significand << 1) >> (64 - fractionBits);
+   }
+}
+
+FloatClass A::classify(Extended a) {
+   if (biased(a) == MAX_EXPONENT)
+      return (a.significand << 1) ? FloatClass::NaN : FloatClass::Infinity;
+   if (a.significand == 0)
+      return FloatClass::Zero;
+   return a.significand & INTEGER_BIT && biased(a) ? FloatClass::Normal : FloatClass::Denormal;
+}
+
+Extended A::add(Extended a, Extended b, FloatEnvironment& environment) {
+   if (isNaN(a) || isNaN(b))
+      return propagate(a, b, environment);
+   if (isInfinity(a) || isInfinity(b)) {
+      if (isInfinity(a) && isInfinity(b) && negative(a) != negative(b))
+         return invalid(environment);
+      return isInfinity(a) ? a : b;
+   }
+   checkDenormal(a, environment);
+   checkDenormal(b, environment);
+   if (a.significand == 0 && b.significand == 0) // the sum of zeros of different signs is +0, -0 rounding down
+      return zero(negative(a) == negative(b) ? negative(a) : environment.rounding == Rounding::Down);
+   if (b.significand == 0)
+      return result(unpack(a), environment);
+   if (a.significand == 0)
+      return result(unpack(b), environment);
+
+   Unpacked x = unpack(a), y = unpack(b);
+   normalize(x);
+   normalize(y);
+   if (x.exponent < y.exponent || (x.exponent == y.exponent && x.hi < y.hi)) { // x is the larger in magnitude
+      const Unpacked larger = y;
+      y = x;
+      x = larger;
+   }
+   shiftRight(y.hi, y.lo, x.exponent - y.exponent);
+   if (x.sign == y.sign) {
+      const uint64_t lo = x.lo + y.lo;
+      const uint64_t hi = x.hi + y.hi + (lo < x.lo);
+      const bool carry = hi < x.hi || (hi == x.hi && lo < x.lo);
+      x.hi = hi;
+      x.lo = lo;
+      if (carry) {
+         shiftRight(x.hi, x.lo, 1);
+         x.hi |= INTEGER_BIT;
+         x.exponent++;
+      }
+   } else {
+      const uint64_t lo = x.lo - y.lo;
+      x.hi = x.hi - y.hi - (x.lo < y.lo);
+      x.lo = lo;
+      if (x.hi == 0 && x.lo == 0)
+         return zero(environment.rounding == Rounding::Down);
+   }
+   return result(x, environment);
+}
+
+Extended A::subtract(Extended a, Extended b, FloatEnvironment& environment) {
+   if (isNaN(b))
+      return propagate(a, b, environment);
+   return add(a, negate(b), environment);
+}
+
+Extended A::multiply(Extended a, Extended b, FloatEnvironment& environment) {
+   if (isNaN(a) || isNaN(b))
+      return propagate(a, b, environment);
+   const bool sign = negative(a) != negative(b);
+   if (isInfinity(a) || isInfinity(b)) {
+      if (a.significand == 0 || b.significand == 0)
+         return invalid(environment);
+      return infinity(sign);
+   }
+   checkDenormal(a, environment);
+   checkDenormal(b, environment);
+   if (a.significand == 0 || b.significand == 0)
+      return zero(sign);
+   Unpacked x = unpack(a), y = unpack(b);
+   normalize(x);
+   normalize(y);
+   Unpacked product = { sign, x.exponent + y.exponent + 1, 0, 0 };
+   multiply64(x.hi, y.hi, product.hi, product.lo);
+   return result(product, environment);
+}
+
+Extended A::divide(Extended a, Extended b, FloatEnvironment& environment) {
+   if (isNaN(a) || isNaN(b))
+      return propagate(a, b, environment);
+   const bool sign = negative(a) != negative(b);
+   if (isInfinity(a))
+      return isInfinity(b) ? invalid(environment) : infinity(sign);
+   if (isInfinity(b))
+      return zero(sign);
+   if (b.significand == 0) {
+      if (a.significand == 0)
+         return invalid(environment);
+      environment.exceptions |= Exception::ZeroDivide;
+      return infinity(sign);
+   }
+   checkDenormal(a, environment);
+   checkDenormal(b, environment);
+   if (a.significand == 0)
+      return zero(sign);
+
+   Unpacked x = unpack(a), y = unpack(b);
+   normalize(x);
+   normalize(y);
+   // Restoring division of the significands, a quotient bit at a time; carry is bit 64 of the remainder
+   uint64_t r = x.hi, q = 0;
+   int exponent = x.exponent - y.exponent;
+   bool carry = false;
+   if (r < y.hi) {
+      carry = r >> 63;
+      r <<= 1;
+      exponent--;
+   }
+   for (int bit = 63; bit >= 0; bit--) {
+      if (carry || r >= y.hi) {
+         r -= y.hi;
+         q |= 1ull << bit;
+      }
+      carry = r >> 63;
+      r <<= 1;
+   }
+   const bool half = carry || r >= y.hi;
+   if (half)
+      r -= y.hi;
+   return result({ sign, exponent, q, (uint64_t)half << 63 | (r != 0) }, environment);
+}
+
+Extended A::squareRoot(Extended a, FloatEnvironment& environment) {
+   if (isNaN(a))
+      return propagate(a, a, environment);
+   if (a.significand == 0)
+      return a;
+   if (negative(a))
+      return invalid(environment);
+   if (isInfinity(a))
+      return a;
+   checkDenormal(a, environment);
+
+   Unpacked x = unpack(a);
+   normalize(x);
+   // The root of the significand scaled by 2^63 (an even exponent) or 2^64 (odd), a bit at a time
+   const bool odd = x.exponent & 1;
+   const uint64_t hi = odd ? x.hi : x.hi >> 1, lo = odd ? 0 : x.hi << 63;
+   uint64_t root = 0, remainderHi = 0, remainderLo = 0;
+   for (int i = 63; i >= 0; i--) {
+      const int shift = 2 * i;
+      const uint64_t bits = shift >= 64 ? hi >> (shift - 64) & 3 : lo >> shift & 3;
+      remainderHi = remainderHi << 2 | remainderLo >> 62;
+      remainderLo = remainderLo << 2 | bits;
+      const uint64_t trialHi = root >> 62, trialLo = root << 2 | 1;
+      root <<= 1;
+      if (remainderHi > trialHi || (remainderHi == trialHi && remainderLo >= trialLo)) {
+         remainderHi = remainderHi - trialHi - (remainderLo < trialLo);
+         remainderLo -= trialLo;
+         root |= 1;
+      }
+   }
+   // The root is never exactly halfway between two values: a remainder above the root is more than half
+   const bool half = remainderHi != 0 || remainderLo > root;
+   const bool sticky = remainderHi != 0 || remainderLo != 0;
+   return result({ false, (x.exponent - odd) / 2, root, (uint64_t)half << 63 | sticky }, environment);
+}
+
+int A::compare(Extended a, Extended b, FloatEnvironment& environment) {
+   if (isNaN(a) || isNaN(b)) {
+      environment.exceptions |= Exception::Invalid;
+      return 2;
+   }
+   checkDenormal(a, environment);
+   checkDenormal(b, environment);
+   if (a.significand == 0 && b.significand == 0)
+      return 0;
+   if (negative(a) != negative(b))
+      return negative(a) ? -1 : 1;
+   Unpacked x = a.significand ? unpack(a) : Unpacked{}, y = b.significand ? unpack(b) : Unpacked{};
+   if (a.significand) normalize(x);
+   if (b.significand) normalize(y);
+   int order;
+   if (a.significand == 0 || b.significand == 0)
+      order = a.significand ? 1 : -1;
+   else if (x.exponent != y.exponent)
+      order = x.exponent > y.exponent ? 1 : -1;
+   else
+      order = x.hi == y.hi ? 0 : x.hi > y.hi ? 1 : -1;
+   return negative(a) ? -order : order;
+}
+
+Extended A::roundToInteger(Extended a, FloatEnvironment& environment) {
+   if (isNaN(a))
+      return propagate(a, a, environment);
+   if (isInfinity(a) || a.significand == 0 || biased(a) - BIAS >= 63)
+      return a;
+   return integer(negative(a), integerPart(a, environment));
+}
+
+Extended A::scale(Extended a, Extended b, FloatEnvironment& environment) {
+   if (isNaN(a) || isNaN(b))
+      return propagate(a, b, environment);
+   if (isInfinity(b)) {
+      if (negative(b) ? isInfinity(a) : a.significand == 0)
+         return invalid(environment);
+      return negative(b) ? zero(negative(a)) : a.significand ? infinity(negative(a)) : a;
+   }
+   if (isInfinity(a) || a.significand == 0)
+      return a;
+   FloatEnvironment chop = { 64, Rounding::Chop };
+   const int64_t n = biased(b) - BIAS >= 31 ? (negative(b) ? -0x7FFF'FFFF : 0x7FFF'FFFF) : toInteger(b, chop);
+   Unpacked x = unpack(a);
+   normalize(x);
+   const int64_t exponent = x.exponent + n; // far enough out of range either way to overflow or underflow
+   x.exponent = (int)(exponent < -100'000 ? -100'000 : exponent > 100'000 ? 100'000 : exponent);
+   return result(x, environment);
+}
+
+void A::extract(Extended a, Extended& exponent, Extended& significand, FloatEnvironment& environment) {
+   if (isNaN(a)) {
+      exponent = significand = propagate(a, a, environment);
+   } else if (isInfinity(a)) {
+      exponent = infinity(false);
+      significand = a;
+   } else if (a.significand == 0) {
+      environment.exceptions |= Exception::ZeroDivide;
+      exponent = infinity(true);
+      significand = a;
+   } else {
+      checkDenormal(a, environment);
+      Unpacked x = unpack(a);
+      normalize(x);
+      exponent = fromInteger(x.exponent);
+      significand = make(x.sign, BIAS, x.hi);
+   }
+}
+
+Extended A::remainder(Extended a, Extended b, int& quotient, bool& complete, FloatEnvironment& environment) {
+   quotient = 0;
+   complete = true;
+   if (isNaN(a) || isNaN(b))
+      return propagate(a, b, environment);
+   if (isInfinity(a) || b.significand == 0)
+      return invalid(environment);
+   if (isInfinity(b) || a.significand == 0)
+      return a;
+   checkDenormal(a, environment);
+   checkDenormal(b, environment);
+
+   Unpacked x = unpack(a), y = unpack(b);
+   normalize(x);
+   normalize(y);
+   int difference = x.exponent - y.exponent;
+   if (difference < 0)
+      return result(x, environment);
+   if (difference >= 64) { // reduce by b * 2^(difference - 63) this time
+      y.exponent += difference - 63;
+      difference = 63;
+      complete = false;
+   }
+   // Shift and subtract: a quotient bit for each bit the exponents differ by, and one more
+   uint64_t r = x.hi, q = 0;
+   bool carry = false;
+   for (int i = 0; i <= difference; i++) {
+      q <<= 1;
+      if (carry || r >= y.hi) {
+         r -= y.hi;
+         q |= 1;
+      }
+      if (i < difference) {
+         carry = r >> 63;
+         r <<= 1;
+      }
+   }
+   quotient = (int)(q & 7);
+   if (r == 0)
+      return zero(x.sign);
+   FloatEnvironment exact;
+   return result({ x.sign, y.exponent, r, 0 }, exact);
+}
+
+Extended A::fromInteger(int64_t value) {
+   return integer(value < 0, value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
+}
+
+
+int64_t A::toInteger(Extended a, FloatEnvironment& environment) {
+   if (isNaN(a) || isInfinity(a) || (a.significand != 0 && biased(a) - BIAS >= 63 && !(negative(a) && biased(a) - BIAS == 63 && a.significand == INTEGER_BIT))) {
+      environment.exceptions |= Exception::Invalid;
+      return INT64_MIN;
+   }
+   if (a.significand == 0)
+      return 0;
+   checkDenormal(a, environment);
+   const uint64_t magnitude = integerPart(a, environment);
+   if (magnitude > (negative(a) ? 1ull << 63 : (1ull << 63) - 1)) {
+      environment.exceptions |= Exception::Invalid;
+      return INT64_MIN;
+   }
+   return negative(a) ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+}
+
+Extended A::fromSingle(uint32_t bits, FloatEnvironment& environment) { return widen(bits, 8, 23, environment); }
+Extended A::fromDouble(uint64_t bits, FloatEnvironment& environment) { return widen(bits, 11, 52, environment); }
+uint32_t A::toSingle(Extended a, FloatEnvironment& environment) { return (uint32_t)narrow(a, 8, 23, environment); }
+uint64_t A::toDouble(Extended a, FloatEnvironment& environment) { return narrow(a, 11, 52, environment); }
+
+Extended A::fromTemporary(const byte* bytes) {
+   Extended a;
+   memcpy(&a.significand, bytes, 8);
+   memcpy(&a.exponent, bytes + 8, 2);
+   return a;
+}
+
+void A::toTemporary(Extended a, byte* bytes) {
+   memcpy(bytes, &a.significand, 8);
+   memcpy(bytes + 8, &a.exponent, 2);
+}
+
+Extended A::fromHost(double value) {
+   uint64_t bits;
+   memcpy(&bits, &value, sizeof bits);
+   FloatEnvironment environment;
+   return fromDouble(bits, environment);
+}
+
+double A::toHost(Extended a) {
+   FloatEnvironment environment;
+   const uint64_t bits = toDouble(a, environment);
+   double value;
+   memcpy(&value, &bits, sizeof value);
+   return value;
+}
+
+Extended A::constant(int index) {
+   // The 8087's constants, rounded to nearest (8087 Family: FLD1 ... FLDZ)
+   static constexpr Extended constants[7] = {
+      { 0x8000'0000'0000'0000, 0x3FFF }, // 1
+      { 0xD49A'784B'CD1B'8AFE, 0x4000 }, // log2(10)
+      { 0xB8AA'3B29'5C17'F0BC, 0x3FFF }, // log2(e)
+      { 0xC90F'DAA2'2168'C235, 0x4000 }, // pi
+      { 0x9A20'9A84'FBCF'F799, 0x3FFD }, // log10(2)
+      { 0xB172'17F7'D1CF'79AC, 0x3FFE }, // ln(2)
+      { 0, 0 }                           // 0
+   };
+   return constants[index];
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Common.h"
+#include <cstdint>
+
+// The 8087's arithmetic, for each type its registers can be kept in (see I8087)
+
+// Rounding control, bits 11-10 of the control word
+enum class Rounding : byte { Nearest, Down, Up, Chop };
+// Exception flags, bits 5-0 of the status word and the masks of the control word
+struct Exception {
+   enum : byte { Invalid = 0x01, Denormal = 0x02, ZeroDivide = 0x04, Overflow = 0x08, Underflow = 0x10, Precision = 0x20 };
+};
+// What an operation takes from the control word, and the exceptions it raised
+struct FloatEnvironment {
+   int precision = 64; // significand bits results are rounded to (precision control: 24, 53 or 64)
+   Rounding rounding = Rounding::Nearest;
+   byte exceptions = 0;
+};
+enum class FloatClass { Zero, Denormal, Normal, Infinity, NaN };
+
+// Temporary real, the 8087's own format: 64-bit significand with an explicit integer bit, 15-bit exponent
+// biased by 16383 and sign. Calculated in software with the 8087's rounding, so results are those of the chip.
+struct Extended {
+   uint64_t significand = 0;
+   word exponent = 0; // bit 15 the sign
+};
+
+// Operations on Real, each raising its exceptions in the environment and returning the masked response
+// (NaN for an invalid operation, infinity for a zero divide or overflow). Arithmetic<Extended> is defined
+// in Extended.cpp and Arithmetic<double> in I8087.cpp.
+template<typename Real> struct Arithmetic;
+
+template<> struct Arithmetic<Extended> {
+   static Extended add(Extended a, Extended b, FloatEnvironment& environment);
+   static Extended subtract(Extended a, Extended b, FloatEnvironment& environment);
+   static Extended multiply(Extended a, Extended b, FloatEnvironment& environment);
+   static Extended divide(Extended a, Extended b, FloatEnvironment& environment);
+   static Extended squareRoot(Extended a, FloatEnvironment& environment);
+   // -1 if a < b, 0 if equal, 1 if a > b, 2 if unordered (a NaN, which is an invalid operation)
+   static int compare(Extended a, Extended b, FloatEnvironment& environment);
+   static Extended negate(Extended a) { a.exponent ^= 0x8000; return a; }
+   static Extended absolute(Extended a) { a.exponent &= 0x7FFF; return a; }
+   static bool negative(Extended a) { return a.exponent & 0x8000; }
+   static FloatClass classify(Extended a);
+
+   static Extended roundToInteger(Extended a, FloatEnvironment& environment);
+   // a * 2^b, b chopped to an integer
+   static Extended scale(Extended a, Extended b, FloatEnvironment& environment);
+   // a = significand * 2^exponent, 1 <= |significand| < 2
+   static void extract(Extended a, Extended& exponent, Extended& significand, FloatEnvironment& environment);
+   // Partial remainder of a / b with the chopped quotient's low 3 bits; incomplete (complete false) if the
+   // exponents differ by 64 or more, in which case it is to be taken again
+   static Extended remainder(Extended a, Extended b, int& quotient, bool& complete, FloatEnvironment& environment);
+
+   static Extended fromInteger(int64_t value);
+   // Rounded by the environment; an invalid operation (and INT64_MIN) if out of range
+   static int64_t toInteger(Extended a, FloatEnvironment& environment);
+   // Short, long and temporary real as stored in memory
+   static Extended fromSingle(uint32_t bits, FloatEnvironment& environment);
+   static Extended fromDouble(uint64_t bits, FloatEnvironment& environment);
+   static Extended fromTemporary(const byte* bytes);
+   static uint32_t toSingle(Extended a, FloatEnvironment& environment);
+   static uint64_t toDouble(Extended a, FloatEnvironment& environment);
+   static void toTemporary(Extended a, byte* bytes);
+   // For what is calculated by the host (the transcendental instructions)
+   static Extended fromHost(double value);
+   static double toHost(Extended a);
+
+   static Extended indefinite() { return { 0xC000'0000'0000'0000, 0xFFFF }; } // the default NaN
+   // FLD1, FLDL2T, FLDL2E, FLDPI, FLDLG2, FLDLN2 and FLDZ, in the order of their opcodes
+   static Extended constant(int index);
+};
@@ -4,12 +4,12 @@
 
 
 
-void I8086::push(word value) { mem<word>(segRegs.SS, (pi_regs.SP -= 2)) = value; }
-word I8086::pop() { return mem<word>(segRegs.SS, (pi_regs.SP += 2) - 2); }
+void I8086::push(word value) { write<word>(segRegs.SS, (regs[SP] -= 2), value); }
+word I8086::pop() { return read<word>(segRegs.SS, (regs[SP] += 2) - 2); }
 
 void I8086::reset() {
    /// [I]nitializes the system as shown in Table 2-4. (8086 Family p2-29:System Reset)
-   alu.flags.clear();
+   alu.current().clear();
    IP = 0;
    segRegs.CS = 0xffff;
    segRegs.DS = 0;
@@ -18,135 +18,108 @@ void I8086::reset() {
 
    /// The processor leaves the halt state upon activation of the RESET line (8086 Family p2-48:HLT)
    halted = false;
+   checkInterrupts();
 }
 
-I8086::I8086(Memory* memory, IO* io) : memory(memory), io(io) { reset(); }
+I8086::I8086(Memory* memory, IO* io) : decoded(DECODED_ENTRIES), memory(memory), io(io), scheduler(cycles),
+   interruptEvent(scheduler.add([this] { takeInterrupts(); })), pic(INTR, scheduler, interruptEvent), pit(pic, scheduler),
+   video(*memory, cycles) {
+   io->attach(0x20, 0x21, &pic);
+   io->attach(0x40, 0x43, &pit);
+   io->attach(0x3B0, 0x3BF, &video);
+   io->attach(0x3D0, 0x3DF, &video);
+   memory->map(Display::MDA_BUFFER, Display::MDA_SIZE, Memory::PageType::WATCHED, &video);
+   memory->map(Display::CGA_BUFFER, Display::CGA_SIZE, Memory::PageType::WATCHED, &video);
+   reset();
+}
 I8086::~I8086() { delete memory; delete io; }
+
+I8086::State I8086::state() {
+   State state;
+   memcpy(state.regs, regs, sizeof state.regs);
+   state.ES = segRegs.ES;
+   state.CS = segRegs.CS;
+   state.SS = segRegs.SS;
+   state.DS = segRegs.DS;
+   state.IP = IP;
+   state.flags = alu.current().get<word>();
+   state.halted = halted;
+   state.INTR = INTR;
+   return state;
+}
+
+void I8086::restore(const State& state) {
+   memcpy(regs, state.regs, sizeof state.regs);
+   segRegs = { state.ES, state.CS, state.SS, state.DS };
+   IP = state.IP;
+   alu.current().set(state.flags);
+   halted = state.halted;
+   INTR = state.INTR;
+   stepping = false;
+   checkInterrupts();
+}
 void I8086::externalInterrupt(unsigned int vector) {
-   if (alu.flags.I)
+   if (alu.flags.I) {
+      halted = false;
       interrupt(vector);
+   }
 }
 void I8086::interrupt(unsigned int vector) {
-   push(alu.flags.get<word>());
-   auto temp = alu.flags.T;
+   if (nativeInterrupt(vector)) // the BIOS service has run and returned
+      return;
+   push(alu.current().get<word>());
    alu.flags.I = alu.flags.T = 0;
-   push(segRegs.CS); push(IP);
-   /// Call interrupt service routine
-   callfar(vector);
-   if (false) // non maskable interrupt
-      interrupt(0); // which vector?
-   else if (temp)
-      interrupt(0);
-   /// Execute user interrupt procedure
-   returnFar();
-   alu.flags.set<word>(pop());
-   // resume interrupted procedure
+   push(segRegs.CS);
+   push(IP);
+   loadFarPointer(segRegs.CS, IP, vector * 4);
 }
 
-// r8 register mode
-template<>
-byte& I8086::reg() {
-   switch (_reg) {
-   case 0: return d_regs.a.l;
-   case 1: return d_regs.c.l;
-   case 2: return d_regs.d.l;
-   case 3: return d_regs.b.l;
-   case 4: return d_regs.a.h;
-   case 5: return d_regs.c.h;
-   case 6: return d_regs.d.h;
-   default:return d_regs.b.h;
+void I8086::takeInterrupts() {
+   // 8086 Family Figure 2-29: Interrupt Processing Sequence, after an instruction
+   if (INTR && alu.flags.I) {
+      halted = false; // an interrupt ends the halt state (8086 Family p2-48:HLT)
+      cycles += 61;   // INTR acknowledge and transfer (8086 Family Table 2-21)
+      interrupt(pic.acknowledge());
    }
+   // A trap follows each instruction started with TF set. Taken after an interrupt, it runs before the
+   // interrupt's handler, which then is not single stepped since TF is now clear
+   if (stepping) {
+      cycles += 50;
+      interrupt(1);
+   }
+   stepping = alu.flags.T;
+   if (stepping || (INTR && alu.flags.I)) // again after the next instruction
+      scheduler.schedule(interruptEvent, cycles + 1);
 }
-// r16 register mode
-template<>
-word& I8086::reg() {
-   switch (_reg) {
-   case 0: return d_regs.a.x;
-   case 1: return d_regs.c.x;
-   case 2: return d_regs.d.x;
-   case 3: return d_regs.b.x;
-   case 4: return pi_regs.SP;
-   case 5: return pi_regs.BP;
-   case 6: return pi_regs.SI;
-   default:return pi_regs.DI;
+
+word& I8086::segmentRegister(int number) {
+   switch (number) {
+   case 0: return segRegs.ES;
+   case 1: return segRegs.CS;
+   case 2: return segRegs.SS;
+   default:return segRegs.DS;
    }
 }
 
 void I8086::fetchModRM() {
    // (IA V2 2-1 Table 2-1 Intel Architecture Instruction Format)
    // (8086 Family 4-19 Figure 4-20 Typical 8086/8088 Machine Instruction Format)
-   byte addrbyte = imm<byte>();
+   // The byte and its displacement were read by decode(); what the byte means comes from modrmTable
+   modrm = &modrmTable[op->modrm];
+   _mode = modrm->mode;
+   _reg = modrm->reg;
+   _rm = modrm->rm;
+   disp16 = op->disp;
 
-   _mode = (addrbyte >> 6) & 0b011; // 1100 0000
-   _reg = (addrbyte >> 3) & 0b111; // 0011 1000
-   _rm = (addrbyte >> 0) & 0b111; // 0000 0111
+   if (modrm->isRegister) // register access
+      return;
 
-   bool BP = (_rm == 2) || (_rm == 3) || (_rm == 6); // If the BP index is used
+   if (!segoverride) // (See note 1)
+      segment = segmentRegister(modrm->segment);
 
-   // Check to see if there is a displacement byte or word
-   switch (_mode) {
-   case 0: // No offset, but rm=6 uses disp16 instead of [BP] like the rest
-   {
-      if (_rm == 6) // No segment override, just uses an immediate displacement
-         disp16 = imm<word>();
-      else if (!segoverride && BP) // (See note 1)
-         segment = segRegs.SS;
-      break;
-   }
-   case 1: // 8 bit offset (see note 2)
-   {
-      disp16 = (int16_t)imm<byte>(); // Sign extend immediate byte to 16 bit
-      if (!segoverride && BP) // (See note 1)
-         segment = segRegs.SS;
-      break;
-   }
-   case 2: // 16 bit offset (see note 3)
-   {
-      disp16 = imm<word>();
-      if (!segoverride && BP) // (See note 1)
-         segment = segRegs.SS;
-      break;
-   }
-   default: // no displacement, register access
-      disp16 = 0;
-   }
+   _ea = (segment << 4) + offset();
    /// 1) The default segment register is SS for the effective addresses containing a BP index, DS for other effective addresses.
    /// 2) The "disp16" nomenclature denotes a 16-bit displacement following the ModR/M byte, to be added to the index.
    /// 3) The "disp8" nomenclature denotes an 8 bit displacement following the ModR/M byte, to be sign-extended and added to the index.
    /// (IA V2 2-4 Table 2-1)
-}
-
-int I8086::ea() {
-   int tempea = 0;
-   switch (_mode) {
-   case 0: // no displacement, but case six is special
-      switch (_rm) {
-      case 0:  tempea = d_regs.b.x + pi_regs.SI; break;
-      case 1:  tempea = d_regs.b.x + pi_regs.DI; break;
-      case 2:  tempea = pi_regs.BP + pi_regs.SI; break;
-      case 3:  tempea = pi_regs.BP + pi_regs.DI; break;
-      case 4:  tempea = pi_regs.SI;              break;
-      case 5:  tempea = pi_regs.DI;              break;
-      case 6:  tempea = disp16;                  break;
-      default: tempea = d_regs.b.x;              break;
-      }
-      break;
-   case 1: // disp8 (already been sign extended to 16 bit)
-   case 2: // disp16
-      switch (_rm) {
-      case 0:  tempea = d_regs.b.x + pi_regs.SI + disp16; break;
-      case 1:  tempea = d_regs.b.x + pi_regs.DI + disp16; break;
-      case 2:  tempea = pi_regs.BP + pi_regs.SI + disp16; break;
-      case 3:  tempea = pi_regs.BP + pi_regs.DI + disp16; break;
-      case 4:  tempea = pi_regs.SI + disp16;              break;
-      case 5:  tempea = pi_regs.DI + disp16;              break;
-      case 6:  tempea = pi_regs.BP + disp16;              break;
-      default: tempea = d_regs.b.x + disp16;              break;
-      }
-      break;
-   default: // register access, no displacement
-      break;
-   }
-
-   return (segment << 4) + (tempea & 0xFFFF);
 }
\ No newline at end of file
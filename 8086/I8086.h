@@ -1,10 +1,18 @@
 #pragma once
 #include "alu.h"
 #include "Common.h"
+#include "Disk.h"
+#include "Display.h"
+#include "I8253.h"
+#include "I8259.h"
+#include "I8087.h"
 #include "IO.h"
 #include "Memory.h"
+#include "ModRM.h"
 
 #include <cassert> /* assert */
+#include <cstring> /* memcpy */
+#include <vector>
 
 
 // Reserved memory space:
@@ -17,33 +25,16 @@ private:
 
    /// REGISTERS ///
    // The 8086 has eight 16-bit general purpose registers divided into two groups:
-   // Data, and Pointer and Index group
-
-   // 4 16-bit general purpose registers which allow high and low byte access
-   struct DRegisters { // Data Registers
-      // A register which allows access to high byte, low byte, or entire byte
-      typedef union {
-         word x; // word (2 bytes)
-         struct {
-            byte l; // low byte
-            byte h; // high byte
-         };
-      } Register;
-      Register a; // Accumulator
-      Register b; // Base
-      Register c; // Count
-      Register d; // Data
-
-   } d_regs;
-
-   // 4 16-bit general purpose registers
-   struct PIRegisters { // Pointer and Index Registers
-      word SI; // Source Index
-      word DI; // Destination Index
-      word BP; // Base Pointer
-      // Points to the top of the stack, or rather the offset from the top of the stack
-      word SP; // Stack Pointer
-   } pi_regs;
+   // Data (AX BX CX DX, which allow high and low byte access), and Pointer and Index (SP BP SI DI).
+   // They are kept in one array in the order of the reg field (8086 Family Table 4-9), so a register
+   // operand is a single indexed access and the whole set can be copied as one block.
+   enum Register { AX, CX, DX, BX, SP, BP, SI, DI };
+   enum ByteRegister { AL, CL, DL, BL, AH, CH, DH, BH };
+   // Accumulator, Count, Data, Base, Stack Pointer, Base Pointer, Source Index, Destination Index,
+   // and ModRM::NO_REGISTER, which is never written and reads 0 in offset()
+   word regs[ModRM::NO_REGISTER + 1] = {};
+   // Byte offset into regs of AL CL DL BL AH CH DH BH (low byte first)
+   static constexpr byte byteRegisters[8] = { 0, 2, 4, 6, 1, 3, 5, 7 };
 
    // The megabyte of memory space is divided into logical segments of up to 64k bytes each.
    // 4 16-bit special purpose registers
@@ -65,16 +56,58 @@ private:
    /// ModR/M ///
    // Parts of the ModR/M byte
    int _mode;
-   struct { int _rm, ext; };
-   int _reg;
+   int _rm;
+   union { int _reg, ext; }; // the reg field is the opcode extension (/0-/7) of group opcodes
    // Not part of the ModR/M byte, but part of processing things related to the byte
    int disp16; // displacement of immediate value after ModR/M byte to be used for calculating the effective address
    int segment; // Segment of memory addressed
    bool segoverride;
+   int _ea; // physical address of a memory r/m operand, latched by fetchModRM()
+   const ModRM* modrm; // modrmTable entry of the instruction being executed
+
+   /// Decoded instruction cache ///
+   // An instruction is decoded once into an entry keyed by the physical address of its first prefix byte.
+   // The entry is reused until a write to its page changes the page's generation in Memory.
+   typedef void (I8086::*Handler)();
+   struct Decoded {
+      Handler handler;         // executes the instruction (see handler())
+      int address = -1;        // physical CS:IP of the first byte; -1 if empty or not cacheable
+      unsigned int generation; // Memory::pageGeneration() of the instruction's page when decoded
+      word length;             // prefixes, opcode, ModR/M, displacement and immediate data
+      word clocks;             // clock cycles as far as known without the data (see clocks())
+      byte opcode;             // for tracing and ESC; handler already encodes it
+      byte segment;            // segment override prefix as a segment register number (ES CS SS DS), NO_OVERRIDE if none
+      byte repeatType;         // RepeatType of a REP/REPE/REPNE prefix
+      byte modrm;              // ModR/M byte, if the opcode has one
+      word disp;               // displacement, sign extended if disp8
+      byte data[4];            // immediate data in instruction order (ptr16:16 is the longest)
+   };
+   enum { NO_OVERRIDE = 4 };
+   enum RepeatType { None, Equal, NEqual };
+   static constexpr int DECODED_ENTRIES = 8192; // direct mapped
+   std::vector<Decoded> decoded;
+   const Decoded* op; // instruction being executed
+   int dataIndex;     // next byte of op->data for imm()
+   RepeatType repeatType; // prefix of the instruction being executed
 
    Memory* memory;
    IO * io;
    ALU alu;
+   Disk* disk = nullptr; // served by diskService(); not owned
+   byte diskStatus = 0;  // of the last INT 13h operation (INT 13h AH=01)
+
+   /// Time and interrupts ///
+   // Clock cycles run: each instruction's decoded clocks, and in Timing::Exact what depends on its data
+   unsigned long long cycles = 0;
+   // Device events and the processor's own, due at clock cycles. run() compares the clock with
+   // scheduler.next between instructions and does nothing else until it is reached
+   Scheduler scheduler;
+   int interruptEvent; // takeInterrupts(), scheduled by INTR going active and by IF or TF being set
+   bool stepping = false; // TF was set at the start of the instruction being executed: trap after it
+   I8259 pic;
+   I8253 pit;
+   Display video; // CGA and MDA text modes
+   Coprocessor* fpu = nullptr; // runs the ESC instructions; not owned
 
    bool halted;
 
@@ -85,29 +118,131 @@ public:
    // Reset/clear alu/segment flags, IP, and leave halt state if in halt state
    void reset();
    void externalInterrupt(unsigned int vector);
-   void run(unsigned int runtime);
 
-   bool INTR;
+   // Disk served by the built in BIOS disk service (INT 13h); the caller keeps ownership
+   void attach(Disk* disk) { this->disk = disk; }
+   // 8087 on the local bus; without one ESC instructions are fetched and ignored. The caller keeps ownership
+   void attach(Coprocessor* fpu) { this->fpu = fpu; }
+   // Text screen of the CGA or MDA buffer
+   Display& display() { return video; }
+   // BIOS bootstrap loader (INT 19h): installs the native BIOS, then the first sector of the attached disk
+   // is loaded at 0000:7C00 and run with DL holding its drive number. False if there is no disk to boot from
+   bool bootstrap();
+   // A key typed, as scan code (high byte) and ASCII code (low byte), queued for INT 16h; false if the
+   // BIOS keyboard buffer is full
+   bool key(word code);
+
+   // What run() records before each instruction executes
+   enum class Trace {
+      Off,    // nothing; no formatting code is compiled into this instantiation
+      Binary, // CS:IP and instruction bytes kept in a ring of the last TRACE_RECORDS (see trace())
+      Text    // disassembly printed to std::cout
+   };
+   struct TraceRecord {
+      word CS, IP;
+      byte code[6]; // the bytes at CS:IP, prefixes included: the longest 8086 instruction without them
+   };
+   static constexpr int TRACE_RECORDS = 1 << 16; // a power of 2
+   // The records kept, oldest first, and the number of instructions traced since the last clearTrace(),
+   // which is more than were kept once the ring has wrapped
+   std::vector<TraceRecord> trace() const;
+   unsigned long long traced() const { return traceCount; }
+   void clearTrace() { traceRing.clear(); traceCount = 0; }
+
+   // Returns the number of instructions executed, fewer than runtime if the processor halted
+   unsigned int run(unsigned int runtime) { return run<Trace::Off>(runtime); }
+   template<Trace TRACE> unsigned int run(unsigned int runtime);
+
+   bool INTR = false; // interrupt request line, driven by the interrupt controller
+
+   // The processor as a checkpoint keeps it (see Checkpoints). Between instructions nothing else of the
+   // 8086 is needed to carry on; the clock, the devices and the coprocessor are not included
+   struct State {
+      word regs[8];
+      word ES, CS, SS, DS;
+      word IP;
+      word flags;
+      bool halted;
+      bool INTR;
+   };
+   State state();
+   void restore(const State& state);
+
+   // How instructions are timed (8086 Family Table 2-21)
+   enum class Timing {
+      Approximate, // the clocks known when decoding: the form, the effective address and the prefixes, with
+                   // branches as taken, shifts by CL as one bit, MUL/DIV in the middle of their range and
+                   // REP string instructions by their elements
+      Exact        // and what depends on the data: branches not taken, INTO taken, the bits shifted, and
+                   // 4 clocks for each word transferred at an odd address
+   };
+   Timing timing = Timing::Approximate;
+   unsigned long long clock() const { return cycles; } // clock cycles run, 4.77 MHz
+
+   // Instructions run from the decoded cache (hits) and decoded from memory (misses)
+   unsigned long long decodeHits = 0, decodeMisses = 0;
 
 private:
-   // Fetches the data pointed to by IP in current code segment
+   // Fetches the data pointed to by IP in current code segment and advances IP
+   template<typename T> T fetch();
+   // Next immediate data of the instruction being executed
    template<typename T> T imm();
 
+   // Decoded entry for the instruction at CS:IP, from the cache or decoded now
+   const Decoded& decode() {
+      const int address = ((segRegs.CS << 4) + IP) & 0xF'FFFF;
+      Decoded& entry = decoded[address & (DECODED_ENTRIES - 1)];
+      if (entry.address == address && entry.generation == memory->pageGeneration(address)) {
+         decodeHits++;
+         return entry;
+      }
+      return decode(entry, address);
+   }
+   const Decoded& decode(Decoded& entry, int address); // miss; decodes into entry
+   word& segmentRegister(int number); // ES CS SS DS in the order of the sreg field
+
    /// ModR/M ///
-   void fetchModRM(); // Read immediate byte and parse as ModR/M byte
+   void fetchModRM(); // Parse the decoded ModR/M byte and latch the effective address
 
-   int ea(); // Effective address using address mode from mod field in ModR/M byte
-   template<typename T> T& reg(); // register access (according to reg field in ModR/M byte)
-   template<typename T> T& rm(); // register/memory access (according to r/m field in ModR/M byte)
+   // Effective address offset: base + index + displacement of the ModR/M byte's address mode
+   word offset() { return (word)(regs[modrm->base] + regs[modrm->index] + disp16); }
+   int ea() { return _ea; } // Physical effective address latched by fetchModRM()
+   template<typename T> T& reg(int index); // register access by register number (8086 Family Table 4-9)
+   template<typename T> T& reg() { return reg<T>(_reg); } // register access (according to reg field in ModR/M byte)
+   template<typename T> T rm(); // register/memory read (according to r/m field in ModR/M byte)
+   template<typename T> void setRM(T value); // register/memory write
 
-   // access memory using default segment
-   template<typename T> T& mem(int index) { return mem<T>(segment, index); }
-   // access memory using specific segment
-   template<typename T> T& mem(int segment, int index) { return memory->mem<T>((segment << 4) + index); }
+   // read memory using default segment
+   template<typename T> T read(int index) { return read<T>(segment, index); }
+   // read memory using specific segment; the offset wraps at 64K
+   template<typename T> T read(int segment, int index) { return memory->read<T>((segment << 4) + (word)index); }
+   // write memory using default segment
+   template<typename T> void write(int index, T value) { write<T>(segment, index, value); }
+   // write memory using specific segment
+   template<typename T> void write(int segment, int index, T value) { memory->write<T>((segment << 4) + (word)index, value); }
 
    void push(word value);
    word pop();
 
+   /// String instructions ///
+   // AL or AX
+   template<typename T> T& accumulator() { return reg<T>(AX); }
+   // SI/DI adjustment per element according to the direction flag
+   template<typename T> word stringStep() { return alu.flags.D ? (word)-(int)sizeof(T) : (word)sizeof(T); }
+   // One element at DS:SI (or the override segment) and/or ES:DI
+   template<typename T> void movs();
+   template<typename T> void stos();
+   template<typename T> void lods();
+   template<typename T> void cmps();
+   template<typename T> void scas();
+   // REP forms; CX elements as a few block copies/fills/searches, identical in effect to repeating the one element forms
+   template<typename T> void repMovs();
+   template<typename T> void repStos();
+   template<typename T> void repLods();
+   // REPE (whileEqual) or REPNE
+   template<typename T> void repCmps(bool whileEqual);
+   template<typename T> void repScas(bool whileEqual);
+
    void callFar(word newIP, word newCS) {
       push(segRegs.CS); push(IP);
       jumpFar(newIP, newCS);
@@ -117,15 +252,18 @@ private:
       jumpFar(address);
    }
    void jumpFar(unsigned int address) {
-      IP = mem<word>(address);
-      segRegs.CS = mem<word>(address + 2);
+      IP = memory->read<word>(address);
+      segRegs.CS = memory->read<word>(address + 2);
    }
    void jumpFar(word newIP, word newCS) {
       IP = newIP;
       segRegs.CS = newCS;
    }
+   // RET and RETF with an immediate also release adjustSP bytes of parameters from the stack
    void returnFar(word adjustSP = 0) {
-      IP = pop(); segRegs.CS = pop() + adjustSP;
+      IP = pop();
+      segRegs.CS = pop();
+      regs[SP] += adjustSP;
    }
 
    void callnear(word offset) {
@@ -140,30 +278,203 @@ private:
    }
    void returnNear(word adjustSP = 0) {
       IP = pop();
-      segRegs.CS += adjustSP;
+      regs[SP] += adjustSP;
    }
 
 
    void loadFarPointer(word& segment, word& index, int address) {
-      index = mem<word>(address);
-      segment = mem<word>(address + 2);
+      index = memory->read<word>(address);
+      segment = memory->read<word>(address + 2);
    }
 
+   // Push the flags, CS and IP, clear IF and TF, and continue at the interrupt's vector (8086 Family Figure 2-29)
    void interrupt(unsigned int vector);
+   // Take a maskable interrupt or single step trap if one is due (interruptEvent)
+   void takeInterrupts();
+   // Have takeInterrupts() run before the next instruction (IF or TF may have been set)
+   void checkInterrupts() { scheduler.schedule(interruptEvent, cycles); }
+
+   /// BIOS services ///
+   // The BIOS is native: installBios() points every interrupt vector at its own entry byte in the BIOS
+   // segment, and an INT through a vector that still points there runs the vector's Service instead of
+   // code in memory, with the effect of the INT and the IRET. A Service returns false to have the
+   // instruction run again (INT 16h waiting for a key); vectors without one just return.
+   typedef bool (I8086::*Service)();
+   static constexpr word BIOS_SEGMENT = 0xF000;
+   static constexpr word BIOS_ENTRIES = 0xFE00; // entry of vector n at F000:FE00+n, opcode F1
+   static Service service(byte vector);
+   void installBios(); // interrupt vectors, entries and the BIOS data area
+   bool nativeInterrupt(unsigned int vector); // false if the vector has been changed, to INT through memory
+   void biosEntry(); // opcode F1: an entry reached by a far CALL or JMP (handlers chaining to the BIOS)
+
+   int chained = -1; // vector a service has run after it returns (INT 08h runs INT 1Ch), -1 if none
+   void chain();     // INT chained, once the service has returned
+
+   bool timerService();     // INT 08h, the timer tick (IR0)
+   bool videoService();     // INT 10h, text modes in the CGA/MDA buffer
+   bool equipmentService(); // INT 11h
+   bool memorySizeService(); // INT 12h
+   bool diskService();      // INT 13h
+   bool keyboardService();  // INT 16h, from the BIOS keyboard buffer filled by key()
+   bool timeService();      // INT 1Ah, the timer tick count
+   // Copy count sectors starting at lba between the disk and ES:BX; false if they are not all on the disk
+   bool transferSectors(int lba, int count, bool toMemory);
+
+   /// Opcode handlers ///
+   // Each executes one decoded instruction with IP already past it. They are defined in I8086Run.cpp
+   // in the order of 8086 Family Table 4-12, with the opcode and group tables that map to them.
+   static Handler handler(byte opcode, byte modrm); // the handler for an opcode, and its /ext if a group opcode
+   // Clocks of an instruction apart from its data, defined in I8086Timing.cpp
+   static word clocks(byte opcode, byte modrm, bool hasModRM, bool repeated);
+   // Timing::Exact only: add clocks that depend on the data
+   void exactClocks(int clocks) { if (timing == Timing::Exact) cycles += clocks; }
+   // A REP string instruction runs in parts that end at the next scheduled event, so that devices and
+   // interrupts are not held off for up to 64K elements. repeatCount() is the elements of CX that fit
+   // before scheduler.next, at least one; the instruction runs them with CX set to that count. repeated()
+   // then charges the elements processed, puts back the ones held over, and if some are left and the
+   // repeat has not ended, moves IP back to the first prefix to run the rest after the event
+   word repeatCount(int clocksPerElement) const {
+      const unsigned long long fit = scheduler.next > cycles ? (scheduler.next - cycles) / clocksPerElement : 0;
+      return fit >= regs[CX] ? regs[CX] : fit == 0 ? (word)(regs[CX] != 0) : (word)fit;
+   }
+   void repeated(word before, word count, int clocksPerElement, bool ended) {
+      cycles += (unsigned int)(word)(count - regs[CX]) * clocksPerElement;
+      regs[CX] += before - count;
+      if (regs[CX] != 0 && !ended)
+         IP -= op->length;
+   }
+
+   // Data transfer
+   template<typename T> void movRmReg();
+   template<typename T> void movRegRm();
+   template<typename T> void movRmImm();
+   template<typename T, int REG> void movRegImm();
+   template<typename T> void movAccMem();
+   template<typename T> void movMemAcc();
+   void movSregRm();
+   void movRmSreg();
+   template<int REG> void pushReg();
+   template<int SREG> void pushSreg();
+   void pushRm();
+   template<int REG> void popReg();
+   template<int SREG> void popSreg();
+   void popRm();
+   template<typename T> void xchgRmReg();
+   template<int REG> void xchgAcc();
+   template<typename T> void inImm();
+   template<typename T> void inDX();
+   template<typename T> void outImm();
+   template<typename T> void outDX();
+   void xlat();
+   void lea();
+   template<int SREG> void loadFar();
+   void pushf();
+   void popf();
+   void sahf();
+   void lahf();
+
+   // Arithmetic and logic; OP is an ALU member, the result is stored unless STORE is false (CMP, TEST)
+   template<typename T, auto OP, bool STORE = true> void aluRmReg();
+   template<typename T, auto OP, bool STORE = true> void aluRegRm();
+   template<typename T, auto OP, bool STORE = true> void aluAccImm();
+   template<typename T, auto OP, bool STORE = true, typename S = T> void aluRmImm(); // S is the immediate's size
+   template<typename T, auto OP> void unaryRm(); // INC DEC
+   template<auto OP, int REG> void unaryReg();
+   template<typename T, auto OP> void mulDivRm(); // MUL IMUL DIV IDIV into AH:AL or DX:AX
+   template<typename T> void notRm();
+   template<typename T> void negRm();
+   template<typename T, auto OP, bool BY_CL> void shiftRm();
+   void aaa();
+   void daa();
+   void aas();
+   void das();
+   void aam();
+   void aad();
+   void cbw();
+   void cwd();
+
+   // String manipulation; the single element form or the REP form according to the prefix
+   template<typename T> void movsOp();
+   template<typename T> void cmpsOp();
+   template<typename T> void scasOp();
+   template<typename T> void lodsOp();
+   template<typename T> void stosOp();
+   template<typename T> void insOp();
+
+   // Control transfer
+   void callRel();
+   void callPtr();
+   void callRm();
+   void callMem();
+   void jumpRel16();
+   void jumpRel8();
+   void jumpPtr();
+   void jumpRm();
+   void jumpMem();
+   void ret();
+   void retImm();
+   void retFar();
+   void retFarImm();
+   template<int CONDITION> void jcc();
+   void loop();
+   void loope();
+   void loopne();
+   void jcxz();
+   void intImm();
+   void int3();
+   void into();
+   void iret();
+
+   // Processor control
+   void halt();
+   void complementCarry();
+   void clearCarry();
+   void setCarry();
+   void clearInterrupt();
+   void setInterrupt();
+   void clearDirection();
+   void setDirection();
+   void escape();
+   void nop();     // also the unused opcodes, which the 8086 executes as NOPs
+   void invalid(); // unused /ext of a group opcode
 
    void disassembleOp();
+   void traceOp(); // add a TraceRecord for the instruction at CS:IP, over the oldest once the ring is full
+   std::vector<TraceRecord> traceRing; // grows to TRACE_RECORDS, then record n is at n % TRACE_RECORDS
+   unsigned long long traceCount = 0;
 };
 
 
 template<typename T>
-T I8086::imm() {
-   T value = mem<T>(segRegs.CS, IP);
+T I8086::fetch() {
+   T value = read<T>(segRegs.CS, IP);
    IP += sizeof(T);
    return value;
 }
 
 template<typename T>
-T& I8086::rm() {
-   if (_mode == 3) return reg<T>();
-   else            return memory->mem<T>(ea());
-}
\ No newline at end of file
+T I8086::imm() {
+   T value;
+   memcpy(&value, &op->data[dataIndex], sizeof(T));
+   dataIndex += sizeof(T);
+   return value;
+}
+
+template<>
+inline byte& I8086::reg(int index) { return ((byte*)regs)[byteRegisters[index]]; }
+template<>
+inline word& I8086::reg(int index) { return regs[index]; }
+
+template<typename T>
+T I8086::rm() {
+   if (_mode == 3) return reg<T>(_rm);
+   if (sizeof(T) == 2 && (_ea & 1)) exactClocks(4); // a word at an odd address takes two bus cycles
+   return memory->read<T>(_ea);
+}
+
+template<typename T>
+void I8086::setRM(T value) {
+   if (_mode == 3) { reg<T>(_rm) = value; return; }
+   if (sizeof(T) == 2 && (_ea & 1)) exactClocks(4);
+   memory->write<T>(_ea, value);
+}
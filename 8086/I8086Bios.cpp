@@ -0,0 +1,497 @@
+#include "I8086.h"
+#include <array>
+
+// BIOS services answered by the emulator itself instead of by BIOS code in memory
+// (IBM PC Technical Reference, BIOS listing: VIDEO_IO, DISKETTE_IO, DISK_IO, KEYBOARD_IO, TIME_OF_DAY and BOOT_STRAP)
+
+namespace {
+   // INT 13h status codes, returned in AH with CF set on an error
+   enum : byte {
+      OK = 0x00,
+      BAD_COMMAND = 0x01,      // function not supported
+      SECTOR_NOT_FOUND = 0x04, // CHS outside the disk
+      TIMEOUT = 0x80           // no such drive
+   };
+
+   // BIOS data area, segment 40h
+   enum : int {
+      BIOS_DATA = 0x400,
+      EQUIPMENT = 0x410,        // word: bit 0 floppies present, bit 1 8087, bits 4-5 initial video mode, bits 6-7 floppies - 1
+      MEMORY_SIZE = 0x413,      // word: KB
+      KEYBOARD_FLAGS = 0x417,   // shift states
+      KEYBOARD_HEAD = 0x41A,    // offsets in segment 40h of the next key to read
+      KEYBOARD_TAIL = 0x41C,    // and of the next free slot
+      VIDEO_MODE = 0x449,
+      VIDEO_COLUMNS = 0x44A,
+      VIDEO_PAGE_SIZE = 0x44C,
+      VIDEO_PAGE_START = 0x44E,
+      CURSOR_POSITION = 0x450,  // word per page: column, row
+      CURSOR_SHAPE = 0x460,     // word: end line, start line
+      VIDEO_PAGE = 0x462,
+      CRTC_PORT = 0x463,
+      TIMER_TICKS = 0x46C,      // dword: ticks since midnight, 18.2 a second
+      TIMER_OVERFLOW = 0x470,   // a midnight has passed since the ticks were last read
+      HARD_DISKS = 0x475,
+      KEYBOARD_START = 0x480,   // offsets in segment 40h of the keyboard buffer
+      KEYBOARD_END = 0x482
+   };
+
+   constexpr unsigned int TICKS_PER_DAY = 0x18'00B0;
+
+   // Flags an IRET from a BIOS service keeps from the service instead of from the stack (RETF 2 in a ROM BIOS)
+   constexpr word RESULT_FLAGS = 0x0041; // Z and C
+
+   /// Text modes ///
+   constexpr int ROWS = 25;
+
+   // Physical address of a character cell; the attribute is the byte after it
+   int cell(Memory* memory, int page, int row, int column) {
+      const int buffer = memory->read<byte>(VIDEO_MODE) == 7 ? 0xB'0000 : 0xB'8000; // MDA : CGA
+      const int offset = page * memory->read<word>(VIDEO_PAGE_SIZE) + (row * memory->read<word>(VIDEO_COLUMNS) + column) * 2;
+      return (buffer + offset) & 0xF'FFFF;
+   }
+
+   // Scroll the window from (top, left) to (bottom, right) of a page up or down by lines, blanking the lines
+   // it leaves with attribute; 0 lines blanks the whole window
+   void scroll(Memory* memory, int page, int top, int left, int bottom, int right, int lines, byte attribute, bool up) {
+      const int columns = memory->read<word>(VIDEO_COLUMNS);
+      if (bottom >= ROWS) bottom = ROWS - 1;
+      if (right >= columns) right = columns - 1;
+      if (top > bottom || left > right)
+         return;
+      const int height = bottom - top + 1;
+      if (lines == 0 || lines > height)
+         lines = height;
+      for (int i = 0; i < height; i++) {
+         const int row = up ? top + i : bottom - i;
+         const int from = up ? row + lines : row - lines;
+         for (int column = left; column <= right; column++) {
+            const word value = i < height - lines ? memory->read<word>(cell(memory, page, from, column)) : (word)(attribute << 8 | ' ');
+            memory->write<word>(cell(memory, page, row, column), value);
+         }
+      }
+   }
+
+   // Write value to the 6845 registers index (high byte) and index + 1 (low byte) of the mode's adapter
+   void crtc(Memory* memory, IO* io, byte index, word value) {
+      const word port = memory->read<word>(CRTC_PORT);
+      io->write<byte>(port, index);
+      io->write<byte>(port + 1, (byte)(value >> 8));
+      io->write<byte>(port, index + 1);
+      io->write<byte>(port + 1, (byte)value);
+   }
+
+   // Have the adapter show the shown page's cursor
+   void showCursor(Memory* memory, IO* io) {
+      const word cursor = memory->read<word>(CURSOR_POSITION + memory->read<byte>(VIDEO_PAGE) * 2);
+      const int start = memory->read<word>(VIDEO_PAGE_START) / 2;
+      crtc(memory, io, 14, (word)(start + (cursor >> 8) * memory->read<word>(VIDEO_COLUMNS) + (cursor & 0xFF)));
+   }
+
+   // INT 10h AH=00: text modes 0-3 (40 or 80 columns) and 7 (MDA); the graphics modes only get their buffer cleared.
+   // The adapter is programmed as by the IBM BIOS: the mode control register, then the 6845 from VIDEO_PARMS
+   void setVideoMode(Memory* memory, IO* io, byte mode, bool clear) {
+      static constexpr byte modeControl[8] = { 0x2C, 0x28, 0x2D, 0x29, 0x2A, 0x2E, 0x1E, 0x29 };
+      static constexpr byte parameters[4][16] = {
+         { 0x38, 0x28, 0x2D, 0x0A, 0x1F, 0x06, 0x19, 0x1C, 0x02, 0x07, 0x06, 0x07, 0, 0, 0, 0 }, // 40x25
+         { 0x71, 0x50, 0x5A, 0x0A, 0x1F, 0x06, 0x19, 0x1C, 0x02, 0x07, 0x06, 0x07, 0, 0, 0, 0 }, // 80x25
+         { 0x38, 0x28, 0x2D, 0x0A, 0x7F, 0x06, 0x64, 0x70, 0x02, 0x01, 0x06, 0x07, 0, 0, 0, 0 }, // graphics
+         { 0x61, 0x50, 0x52, 0x0F, 0x19, 0x06, 0x19, 0x19, 0x02, 0x0D, 0x0B, 0x0C, 0, 0, 0, 0 }  // MDA
+      };
+      const bool text = mode <= 3 || mode == 7;
+      const byte* registers = parameters[mode == 7 ? 3 : !text ? 2 : mode >= 2 ? 1 : 0];
+      memory->write<byte>(VIDEO_MODE, mode);
+      memory->write<word>(VIDEO_COLUMNS, mode <= 1 ? 40 : 80);
+      memory->write<word>(VIDEO_PAGE_SIZE, !text ? 0x4000 : mode <= 1 ? 0x800 : 0x1000);
+      memory->write<word>(VIDEO_PAGE_START, 0);
+      memory->write<byte>(VIDEO_PAGE, 0);
+      memory->write<word>(CRTC_PORT, mode == 7 ? 0x3B4 : 0x3D4);
+      memory->write<word>(CURSOR_SHAPE, (word)(registers[10] << 8 | registers[11]));
+      for (int page = 0; page < 8; page++)
+         memory->write<word>(CURSOR_POSITION + page * 2, 0);
+      if (clear) {
+         const int buffer = mode == 7 ? 0xB'0000 : 0xB'8000, length = mode == 7 ? 0x1000 : 0x4000;
+         for (int i = 0; i < length; i += 2)
+            memory->write<word>(buffer + i, text ? 0x0720 : 0);
+      }
+
+      const word port = memory->read<word>(CRTC_PORT);
+      io->write<byte>(port + 4, mode < 8 ? modeControl[mode] : modeControl[4]);
+      for (int index = 0; index < 16; index++) {
+         io->write<byte>(port, (byte)index);
+         io->write<byte>(port + 1, registers[index]);
+      }
+   }
+}
+
+I8086::Service I8086::service(byte vector) {
+   static constexpr auto services = [] {
+      std::array<Service, 256> table{};
+      table[0x08] = &I8086::timerService;
+      table[0x10] = &I8086::videoService;
+      table[0x11] = &I8086::equipmentService;
+      table[0x12] = &I8086::memorySizeService;
+      table[0x13] = &I8086::diskService;
+      table[0x16] = &I8086::keyboardService;
+      table[0x1A] = &I8086::timeService;
+      return table;
+   }();
+   return services[vector];
+}
+
+void I8086::installBios() {
+   const int bios = BIOS_SEGMENT << 4;
+   for (int vector = 0; vector < 256; vector++) {
+      memory->write<word>(vector * 4, BIOS_ENTRIES + vector);
+      memory->write<word>(vector * 4 + 2, BIOS_SEGMENT);
+      memory->write<byte>(bios + BIOS_ENTRIES + vector, 0xF1);
+   }
+   memory->map(bios, 0x1'0000, Memory::PageType::ROM);
+
+   word equipment = 0x0020; // 80x25 color
+   if (disk && disk->floppy())
+      equipment |= 0x0001; // one floppy drive
+   if (fpu)
+      equipment |= 0x0002; // math coprocessor
+   memory->write<word>(EQUIPMENT, equipment);
+   memory->write<byte>(HARD_DISKS, disk && !disk->floppy() ? 1 : 0);
+   memory->write<word>(MEMORY_SIZE, 640);
+   memory->write<word>(KEYBOARD_START, 0x1E);
+   memory->write<word>(KEYBOARD_END, 0x3E);
+   memory->write<word>(KEYBOARD_HEAD, 0x1E);
+   memory->write<word>(KEYBOARD_TAIL, 0x1E);
+   setVideoMode(memory, io, 3, true);
+
+   // Interrupt controller: edge triggered, single, vectors 08h-0Fh, 8086 mode; the timer, keyboard
+   // and floppy requests unmasked
+   io->write<byte>(0x20, 0x13);
+   io->write<byte>(0x21, 0x08);
+   io->write<byte>(0x21, 0x01);
+   io->write<byte>(0x21, 0xBC);
+   // Timer counter 0: square wave of 65536 counts, the 18.2 Hz tick
+   io->write<byte>(0x43, 0x36);
+   io->write<byte>(0x40, 0x00);
+   io->write<byte>(0x40, 0x00);
+}
+
+bool I8086::nativeInterrupt(unsigned int vector) {
+   if (memory->read<word>(vector * 4) != BIOS_ENTRIES + vector || memory->read<word>(vector * 4 + 2) != BIOS_SEGMENT)
+      return false;
+   const Service service = I8086::service(vector);
+   if (service && !(this->*service)())
+      IP -= op->length; // INT again
+   chain();
+   return true;
+}
+
+void I8086::biosEntry() {
+   const int vector = IP - 1 - BIOS_ENTRIES;
+   if (segRegs.CS != BIOS_SEGMENT || vector < 0 || vector > 0xFF)
+      return; // the 8086 runs F1 as a NOP
+   const Service service = I8086::service(vector);
+   if (service && !(this->*service)()) {
+      IP -= op->length; // run the entry again, with the INT's return address still on the stack
+      return;
+   }
+   const word result = alu.current().get<word>();
+   iret();
+   alu.current().set<word>((alu.current().get<word>() & ~RESULT_FLAGS) | (result & RESULT_FLAGS));
+   chain();
+}
+
+void I8086::chain() {
+   if (chained < 0)
+      return;
+   const unsigned int vector = chained;
+   chained = -1;
+   interrupt(vector);
+}
+
+// INT 08h = Timer tick, from IR0 18.2 times a second
+// Counts the tick in the BIOS data area, ends the interrupt and runs INT 1Ch for programs that hook it
+bool I8086::timerService() {
+   unsigned int ticks = memory->read<word>(TIMER_TICKS) | memory->read<word>(TIMER_TICKS + 2) << 16;
+   if (++ticks == TICKS_PER_DAY) {
+      ticks = 0;
+      memory->write<byte>(TIMER_OVERFLOW, 1);
+   }
+   memory->write<word>(TIMER_TICKS, (word)ticks);
+   memory->write<word>(TIMER_TICKS + 2, (word)(ticks >> 16));
+   io->write<byte>(0x20, 0x20); // non-specific EOI
+   chained = 0x1C;
+   return true;
+}
+
+// INT 10h = Video services
+// AH selects the function. Text is written to the CGA (or MDA, mode 7) buffer, with the cursor in the BIOS data area
+// and in the adapter's 6845
+bool I8086::videoService() {
+   const int page = memory->read<byte>(VIDEO_PAGE);
+   const int columns = memory->read<word>(VIDEO_COLUMNS);
+   switch (reg<byte>(AH)) {
+   case 0x00: // Set mode AL; bit 7 keeps the buffer
+      setVideoMode(memory, io, reg<byte>(AL) & 0x7F, !(reg<byte>(AL) & 0x80));
+      break;
+   case 0x01: // Cursor shape: CH start line, CL end line
+      memory->write<word>(CURSOR_SHAPE, regs[CX]);
+      crtc(memory, io, 10, regs[CX]);
+      break;
+   case 0x02: // Set cursor of page BH to row DH, column DL
+      memory->write<word>(CURSOR_POSITION + (reg<byte>(BH) & 7) * 2, regs[DX]);
+      showCursor(memory, io);
+      break;
+   case 0x03: // Cursor of page BH in DH, DL and its shape in CX
+      regs[DX] = memory->read<word>(CURSOR_POSITION + (reg<byte>(BH) & 7) * 2);
+      regs[CX] = memory->read<word>(CURSOR_SHAPE);
+      break;
+   case 0x05: // Show page AL
+      memory->write<byte>(VIDEO_PAGE, reg<byte>(AL) & 7);
+      memory->write<word>(VIDEO_PAGE_START, (reg<byte>(AL) & 7) * memory->read<word>(VIDEO_PAGE_SIZE));
+      crtc(memory, io, 12, memory->read<word>(VIDEO_PAGE_START) / 2);
+      showCursor(memory, io);
+      break;
+   case 0x06: // Scroll the window CH, CL to DH, DL up by AL lines, blanking with attribute BH
+   case 0x07: // and down
+      scroll(memory, page, reg<byte>(CH), reg<byte>(CL), reg<byte>(DH), reg<byte>(DL), reg<byte>(AL), reg<byte>(BH), reg<byte>(AH) == 0x06);
+      break;
+   case 0x08: // Character in AL and attribute in AH at the cursor of page BH
+   {
+      const word cursor = memory->read<word>(CURSOR_POSITION + (reg<byte>(BH) & 7) * 2);
+      regs[AX] = memory->read<word>(cell(memory, reg<byte>(BH) & 7, cursor >> 8, cursor & 0xFF));
+      break;
+   }
+   case 0x09: // Write character AL with attribute BL CX times at the cursor of page BH, which does not move
+   case 0x0A: // the character only
+   {
+      const word cursor = memory->read<word>(CURSOR_POSITION + (reg<byte>(BH) & 7) * 2);
+      const int first = (cursor >> 8) * columns + (cursor & 0xFF);
+      for (int i = 0; i < regs[CX] && first + i < ROWS * columns; i++) {
+         const int address = cell(memory, reg<byte>(BH) & 7, 0, first + i);
+         memory->write<byte>(address, reg<byte>(AL));
+         if (reg<byte>(AH) == 0x09)
+            memory->write<byte>(address + 1, reg<byte>(BL));
+      }
+      break;
+   }
+   case 0x0E: // Teletype AL on the shown page: bell, backspace, line feed and carriage return are obeyed,
+   {          // and the page scrolls up at the bottom
+      const word cursor = memory->read<word>(CURSOR_POSITION + page * 2);
+      int row = cursor >> 8, column = cursor & 0xFF;
+      switch (reg<byte>(AL)) {
+      case 0x07: break;
+      case 0x08: if (column > 0) column--; break;
+      case 0x0A: row++; break;
+      case 0x0D: column = 0; break;
+      default:
+         memory->write<byte>(cell(memory, page, row, column), reg<byte>(AL));
+         column++;
+         break;
+      }
+      if (column >= columns) {
+         column = 0;
+         row++;
+      }
+      if (row >= ROWS) { // the new line takes the attribute under the cursor
+         row = ROWS - 1;
+         scroll(memory, page, 0, 0, ROWS - 1, columns - 1, 1, memory->read<byte>(cell(memory, page, row, column) + 1), true);
+      }
+      memory->write<word>(CURSOR_POSITION + page * 2, (word)(row << 8 | column));
+      showCursor(memory, io);
+      break;
+   }
+   case 0x0F: // Mode in AL, columns in AH, shown page in BH
+      reg<byte>(AL) = memory->read<byte>(VIDEO_MODE);
+      reg<byte>(AH) = (byte)columns;
+      reg<byte>(BH) = (byte)page;
+      break;
+   }
+   return true;
+}
+
+// INT 11h = Equipment list in AX
+bool I8086::equipmentService() {
+   regs[AX] = memory->read<word>(EQUIPMENT);
+   return true;
+}
+
+// INT 12h = Memory size in KB in AX
+bool I8086::memorySizeService() {
+   regs[AX] = memory->read<word>(MEMORY_SIZE);
+   return true;
+}
+
+bool I8086::bootstrap() {
+   if (!disk || !disk->mapped())
+      return false;
+
+   installBios();
+   segRegs.ES = 0;
+   regs[BX] = 0x7C00;
+   if (!transferSectors(0, 1, true))
+      return false;
+
+   segRegs.CS = 0;
+   IP = 0x7C00;
+   reg<byte>(DL) = disk->drive();
+   halted = false;
+   return true;
+}
+
+bool I8086::transferSectors(int lba, int count, bool toMemory) {
+   byte* sectors = disk->sector(lba);
+   if (count <= 0 || !sectors || !disk->sector(lba + count - 1))
+      return false;
+
+   // Consecutive sectors are consecutive in the image, so the whole transfer is one copy
+   const int bytes = count * Disk::SECTOR;
+   const int address = (segRegs.ES << 4) + regs[BX];
+   if (memory->direct(address, bytes, toMemory)) {
+      if (toMemory) {
+         memcpy(memory->data() + address, sectors, bytes);
+         memory->written(address, bytes);
+      } else {
+         memcpy(sectors, memory->data() + address, bytes);
+      }
+   } else { // wraps past the megabyte, or ROM or a device is mapped there
+      for (int i = 0; i < bytes; i++) {
+         if (toMemory) memory->write<byte>((address + i) & 0xF'FFFF, sectors[i]);
+         else          sectors[i] = memory->read<byte>((address + i) & 0xF'FFFF);
+      }
+   }
+   return true;
+}
+
+// INT 13h = Disk services
+// AH selects the function, DL the drive. Errors set CF and return the status in AH
+bool I8086::diskService() {
+   const byte function = reg<byte>(AH);
+   byte status = OK;
+
+   if (!disk || reg<byte>(DL) != disk->drive() || !disk->mapped()) {
+      status = TIMEOUT;
+   } else switch (function) {
+   case 0x00: // Reset disk system
+      break;
+   case 0x01: // Status of last operation, in AL
+      reg<byte>(AL) = diskStatus;
+      break;
+   case 0x02: // Read sectors:  AL sectors from CH cylinder, CL sector (cylinder bits 8-9 in CL bits 6-7), DH head into ES:BX
+   case 0x03: // Write sectors: AL sectors from ES:BX to the same CHS
+   case 0x04: // Verify sectors
+   {
+      const int cylinder = reg<byte>(CH) | (reg<byte>(CL) & 0xC0) << 2;
+      const int lba = disk->lba(cylinder, reg<byte>(DH), reg<byte>(CL) & 0x3F);
+      const int count = reg<byte>(AL);
+      const bool found = function == 0x04 ? lba >= 0 && count > 0 && disk->sector(lba + count - 1)
+                                          : lba >= 0 && transferSectors(lba, count, function == 0x02);
+      if (!found) {
+         status = SECTOR_NOT_FOUND;
+         reg<byte>(AL) = 0; // sectors transferred
+      }
+      break;
+   }
+   case 0x08: // Drive parameters: CH/CL last cylinder and sectors per track, DH last head, DL number of drives
+   {
+      const int cylinder = disk->cylinders() - 1;
+      reg<byte>(CH) = cylinder & 0xFF;
+      reg<byte>(CL) = (disk->sectorsPerTrack() & 0x3F) | (cylinder >> 2 & 0xC0);
+      reg<byte>(DH) = disk->heads() - 1;
+      reg<byte>(DL) = 1;
+      reg<byte>(AL) = 0;
+      if (disk->floppy()) { // BL drive type: 1 360K, 2 1.2M, 3 720K, 4 1.44M, 6 2.88M
+         switch (disk->sectorsPerTrack()) {
+         case 15: reg<byte>(BL) = 2; break;
+         case 18: reg<byte>(BL) = 4; break;
+         case 36: reg<byte>(BL) = 6; break;
+         default: reg<byte>(BL) = disk->cylinders() == 80 ? 3 : 1; break;
+         }
+      }
+      break;
+   }
+   case 0x15: // Drive type in AH: 1 floppy without change line, 3 hard disk with CX:DX sectors
+      alu.current().C = 0;
+      if (disk->floppy()) {
+         reg<byte>(AH) = 1;
+      } else {
+         reg<byte>(AH) = 3;
+         regs[CX] = disk->sectors() >> 16;
+         regs[DX] = disk->sectors() & 0xFFFF;
+      }
+      diskStatus = OK;
+      return true;
+   default:
+      status = BAD_COMMAND;
+      break;
+   }
+
+   diskStatus = status;
+   reg<byte>(AH) = status;
+   alu.current().C = status != OK;
+   return true;
+}
+
+// INT 16h = Keyboard services
+// AH selects the function. Keys come from the buffer in the BIOS data area, as scan code and ASCII code
+bool I8086::keyboardService() {
+   const word head = memory->read<word>(KEYBOARD_HEAD);
+   const bool empty = head == memory->read<word>(KEYBOARD_TAIL);
+   switch (reg<byte>(AH)) {
+   case 0x00: // Read the next key into AX, waiting for one
+   case 0x10:
+   {
+      if (empty)
+         return false;
+      regs[AX] = memory->read<word>(BIOS_DATA + head);
+      word next = head + 2;
+      if (next >= memory->read<word>(KEYBOARD_END))
+         next = memory->read<word>(KEYBOARD_START);
+      memory->write<word>(KEYBOARD_HEAD, next);
+      break;
+   }
+   case 0x01: // Is a key ready: ZF clear and the key in AX (left in the buffer), ZF set if none
+   case 0x11:
+      alu.current().Z = empty;
+      if (!empty)
+         regs[AX] = memory->read<word>(BIOS_DATA + head);
+      break;
+   case 0x02: // Shift states in AL
+   case 0x12:
+      reg<byte>(AL) = memory->read<byte>(KEYBOARD_FLAGS);
+      break;
+   }
+   return true;
+}
+
+bool I8086::key(word code) {
+   const word tail = memory->read<word>(KEYBOARD_TAIL);
+   word next = tail + 2;
+   if (next >= memory->read<word>(KEYBOARD_END))
+      next = memory->read<word>(KEYBOARD_START);
+   if (next == memory->read<word>(KEYBOARD_HEAD))
+      return false;
+   memory->write<word>(BIOS_DATA + tail, code);
+   memory->write<word>(KEYBOARD_TAIL, next);
+   return true;
+}
+
+// INT 1Ah = Time of day
+// AH selects the function. There is no real time clock (AH=02 and up set CF, as on the PC and XT)
+bool I8086::timeService() {
+   switch (reg<byte>(AH)) {
+   case 0x00: // Ticks since midnight in CX:DX; AL nonzero if midnight has passed since the last read
+      regs[CX] = memory->read<word>(TIMER_TICKS + 2);
+      regs[DX] = memory->read<word>(TIMER_TICKS);
+      reg<byte>(AL) = memory->read<byte>(TIMER_OVERFLOW);
+      memory->write<byte>(TIMER_OVERFLOW, 0);
+      break;
+   case 0x01: // Set the ticks to CX:DX
+      memory->write<word>(TIMER_TICKS + 2, regs[CX]);
+      memory->write<word>(TIMER_TICKS, regs[DX]);
+      memory->write<byte>(TIMER_OVERFLOW, 0);
+      break;
+   default:
+      alu.current().C = 1;
+      break;
+   }
+   return true;
+}
@@ -0,0 +1,97 @@
+#include "I8086.h"
+
+
+namespace {
+   // What follows each opcode (8086 Family Table 4-13)
+   enum : byte {
+      _ = 0,    // nothing
+      B = 1,    // 1 byte of immediate data
+      W = 2,    // 2 bytes
+      D = 4,    // 4 bytes (ptr16:16)
+      M = 0x80, // a ModR/M byte and its displacement, before any data
+      DATA = 0x7
+   };
+   constexpr byte operands[256] = {
+   // 0    1    2    3    4    5    6    7    8    9    A    B    C    D    E    F
+      M,   M,   M,   M,   B,   W,   _,   _,   M,   M,   M,   M,   B,   W,   _,   _,   // 0
+      M,   M,   M,   M,   B,   W,   _,   _,   M,   M,   M,   M,   B,   W,   _,   _,   // 1
+      M,   M,   M,   M,   B,   W,   _,   _,   M,   M,   M,   M,   B,   W,   _,   _,   // 2
+      M,   M,   M,   M,   B,   W,   _,   _,   M,   M,   M,   M,   B,   W,   _,   _,   // 3
+      _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   // 4
+      _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   // 5
+      _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   // 6
+      B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   B,   // 7
+      M|B, M|W, M|B, M|B, M,   M,   M,   M,   M,   M,   M,   M,   M,   M,   M,   M,   // 8
+      _,   _,   _,   _,   _,   _,   _,   _,   _,   _,   D,   _,   _,   _,   _,   _,   // 9
+      W,   W,   W,   W,   _,   _,   _,   _,   B,   W,   _,   _,   _,   _,   _,   _,   // A
+      B,   B,   B,   B,   B,   B,   B,   B,   W,   W,   W,   W,   W,   W,   W,   W,   // B
+      _,   _,   W,   _,   M,   M,   M|B, M|W, _,   _,   W,   _,   _,   B,   _,   _,   // C
+      M,   M,   M,   M,   B,   B,   _,   _,   M,   M,   M,   M,   M,   M,   M,   M,   // D
+      B,   B,   B,   B,   B,   B,   B,   B,   W,   W,   D,   B,   _,   _,   _,   _,   // E
+      _,   _,   _,   _,   _,   _,   M,   M,   _,   _,   _,   _,   _,   _,   M,   M,   // F
+   };
+}
+
+const I8086::Decoded& I8086::decode(Decoded& entry, int address) {
+   decodeMisses++;
+
+   word ip = IP;
+   auto next = [&]() -> byte { return memory->read<byte>(((segRegs.CS << 4) + ip++) & 0xF'FFFF); };
+
+   entry.segment = NO_OVERRIDE;
+   entry.repeatType = None;
+   int prefixClocks = 0;
+   byte opcode;
+   for (bool prefix = true; prefix;) {
+      switch (opcode = next()) {
+         // SEGMENT = Override prefix:         [001 reg 110]
+      case 0x26: case 0x2E: case 0x36: case 0x3E:
+         entry.segment = (opcode >> 3) & 0b11;
+         prefixClocks += 2;
+         break;
+         // LOCK = Bus lock prefix             [11110000]
+      case 0xF0:
+         prefixClocks += 2;
+         break;
+         // REP = Repeat                       [1111001 z]
+      case 0xF2: entry.repeatType = NEqual; break;
+      case 0xF3: entry.repeatType = Equal;  break;
+      default: // Normal opcode
+         prefix = false;
+         break;
+      }
+   }
+   entry.opcode = opcode;
+
+   int data = operands[opcode] & DATA;
+   entry.modrm = 0;
+   entry.disp = 0;
+   if (operands[opcode] & M) {
+      entry.modrm = next();
+      switch (modrmTable[entry.modrm].dispSize) {
+      case 2: // disp16, or a direct address
+         entry.disp = next();
+         entry.disp |= next() << 8;
+         break;
+      case 1: // disp8, sign extended
+         entry.disp = (int8_t)next();
+         break;
+      }
+      // Only TEST (/0) of the unary group has immediate data
+      if ((opcode == 0xF6 || opcode == 0xF7) && ((entry.modrm >> 3) & 0b111) == 0)
+         data = opcode == 0xF6 ? B : W;
+   }
+   for (int i = 0; i < data; i++)
+      entry.data[i] = next();
+   entry.length = (word)(ip - IP);
+   entry.handler = handler(opcode, entry.modrm);
+   entry.clocks = (word)(clocks(opcode, entry.modrm, operands[opcode] & M, entry.repeatType != None) + prefixClocks);
+
+   // Only instructions that sit in one page and do not wrap IP are kept; the rest are decoded every time
+   const int last = address + entry.length - 1;
+   const bool cacheable = IP + entry.length <= 0x1'0000 && last <= 0xF'FFFF
+      && (address >> Memory::PAGE_BITS) == (last >> Memory::PAGE_BITS);
+   entry.address = cacheable ? address : -1;
+   entry.generation = memory->pageGeneration(address);
+   return entry;
+}
@@ -39,7 +39,7 @@ void I8086::disassembleOp() {
    byte opcode;
 
    auto imm8 = [&]() -> byte {
-      byte temp = imm<byte>();
+      byte temp = fetch<byte>();
       bytes << std::setfill('0') << std::setw(2) << std::hex << (int)temp << " ";
       std::cout << bytes.str() << std::endl;
       return temp;
@@ -47,7 +47,7 @@ void I8086::disassembleOp() {
 
    auto imm16 = [&]() -> word {
       union { word x; struct { byte h; byte l; }; } temp;
-      temp.x = imm<word>();
+      temp.x = fetch<word>();
       bytes << std::setfill('0') << std::setw(2) << std::hex << (int)temp.h << " ";
       bytes << std::setfill('0') << std::setw(2) << std::hex << (int)temp.l << " ";
       std::cout << bytes.str() << std::endl;
@@ -68,6 +68,14 @@ void I8086::disassembleOp() {
          }
    }();
 
+   // Only the ModR/M byte; rmString() reads the displacement
+   auto fetchModRM = [&]() {
+      byte addrbyte = imm8();
+      _mode = (addrbyte >> 6) & 0b011;
+      _reg = (addrbyte >> 3) & 0b111;
+      _rm = (addrbyte >> 0) & 0b111;
+   };
+
    auto memRef = [&](std::string address, std::string defaultSegment = "ds") -> std::string {
       return (seg == "" ? defaultSegment : seg) + ":[" + address + "]";
    };
@@ -240,8 +248,8 @@ void I8086::disassembleOp() {
 
    case 0xE4: print("IN", "AL", intToHexUnsigned(imm8())); break;
    case 0xE5: print("IN", "AX", intToHexUnsigned(imm8())); break;
-   case 0xEC: print("IN", "AL", "DX"); break; d_regs.a.l = io->read<byte>(d_regs.d.x); break;
-   case 0xED: print("IN", "AX", "DX"); break; d_regs.a.x = io->read<word>(d_regs.d.x); break;
+   case 0xEC: print("IN", "AL", "DX"); break; accumulator<byte>() = io->read<byte>(regs[DX]); break;
+   case 0xED: print("IN", "AX", "DX"); break; regs[AX] = io->read<word>(regs[DX]); break;
 
    case 0xE6: print("OUT", intToHexUnsigned(imm8()), "AL"); break;
    case 0xE7: print("OUT", intToHexUnsigned(imm8()), "AX"); break;
@@ -0,0 +1,342 @@
+#include "I8086.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STRING_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// String instructions (8086 Family p2-42:String Instructions)
+// REP MOVS, STOS and LODS only ever touch memory through the current segments, so a run of elements
+// that neither wraps a 64K offset nor runs off the top of memory is one linear block and can be moved
+// with memmove/memset. REPE/REPNE CMPS and SCAS search such a block for the element that ends the
+// repeat. Anything else, and blocks over ROM or memory mapped devices, is left to the single element forms below.
+
+namespace {
+   // Number of elements that can be processed starting at segment:offset, going up (down=false)
+   // or down (down=true), before the offset wraps around the segment or the address leaves the megabyte.
+   // 0 if the first element itself straddles one of those boundaries.
+   template<typename T>
+   unsigned int span(int segment, word offset, bool down) {
+      const unsigned int size = sizeof(T);
+      const unsigned int linear = (segment << 4) + offset;
+      if (offset + size > 0x1'0000 || linear + size > 0x10'0000)
+         return 0;
+      if (down)
+         return offset / size + 1;
+      return std::min((0x1'0000 - offset) / size, (0x10'0000 - linear) / size);
+   }
+
+   inline unsigned int lowestBit(unsigned int mask) {
+#if defined(_MSC_VER)
+      unsigned long index; _BitScanForward(&index, mask); return index;
+#else
+      return __builtin_ctz(mask);
+#endif
+   }
+   inline unsigned int highestBit(unsigned int mask) {
+#if defined(_MSC_VER)
+      unsigned long index; _BitScanReverse(&index, mask); return index;
+#else
+      return 31 - __builtin_clz(mask);
+#endif
+   }
+
+   // Vector compare of one register's worth of elements at a with those at b, or with value when b is null.
+   // Returns a byte mask (as _mm_movemask_epi8) with the bytes of every element whose equality is `match` set.
+#if defined(__AVX2__)
+   constexpr unsigned int VECTOR = 32;
+   template<typename T>
+   inline unsigned int compareVector(const byte* a, const byte* b, T value, bool match) {
+      __m256i x = _mm256_loadu_si256((const __m256i*)a);
+      __m256i y = b ? _mm256_loadu_si256((const __m256i*)b)
+         : (sizeof(T) == 1 ? _mm256_set1_epi8((char)value) : _mm256_set1_epi16((short)value));
+      __m256i equal = sizeof(T) == 1 ? _mm256_cmpeq_epi8(x, y) : _mm256_cmpeq_epi16(x, y);
+      unsigned int mask = (unsigned int)_mm256_movemask_epi8(equal);
+      return match ? mask : ~mask;
+   }
+#elif defined(STRING_SSE2)
+   constexpr unsigned int VECTOR = 16;
+   template<typename T>
+   inline unsigned int compareVector(const byte* a, const byte* b, T value, bool match) {
+      __m128i x = _mm_loadu_si128((const __m128i*)a);
+      __m128i y = b ? _mm_loadu_si128((const __m128i*)b)
+         : (sizeof(T) == 1 ? _mm_set1_epi8((char)value) : _mm_set1_epi16((short)value));
+      __m128i equal = sizeof(T) == 1 ? _mm_cmpeq_epi8(x, y) : _mm_cmpeq_epi16(x, y);
+      unsigned int mask = (unsigned int)_mm_movemask_epi8(equal);
+      return (match ? mask : ~mask) & 0xffff;
+   }
+#endif
+
+   template<typename T>
+   inline bool compareElement(const byte* a, const byte* b, T value, bool match) {
+      T x, y = value;
+      memcpy(&x, a, sizeof(T));
+      if (b) memcpy(&y, b, sizeof(T));
+      return (x == y) == match;
+   }
+
+   // Index of the first (down=false) or last (down=true) of n elements at a whose equality with the element
+   // at b, or with value when b is null, is `match`; n if there is none.
+   template<typename T>
+   unsigned int findElement(const byte* a, const byte* b, T value, unsigned int n, bool match, bool down) {
+      const unsigned int size = sizeof(T);
+      if (!down) {
+         unsigned int i = 0;
+#if defined(__AVX2__) || defined(STRING_SSE2)
+         for (; i + VECTOR / size <= n; i += VECTOR / size)
+            if (unsigned int mask = compareVector<T>(a + i * size, b ? b + i * size : nullptr, value, match))
+               return i + lowestBit(mask) / size;
+#endif
+         for (; i < n; i++)
+            if (compareElement<T>(a + i * size, b ? b + i * size : nullptr, value, match))
+               return i;
+      } else {
+         unsigned int i = n;
+#if defined(__AVX2__) || defined(STRING_SSE2)
+         for (; i >= VECTOR / size; i -= VECTOR / size)
+            if (unsigned int mask = compareVector<T>(a + (i - VECTOR / size) * size,
+                  b ? b + (i - VECTOR / size) * size : nullptr, value, match))
+               return i - VECTOR / size + highestBit(mask) / size;
+#endif
+         while (i-- > 0)
+            if (compareElement<T>(a + i * size, b ? b + i * size : nullptr, value, match))
+               return i;
+      }
+      return n;
+   }
+}
+
+template<typename T>
+void I8086::movs() {
+   write<T>(segRegs.ES, regs[DI], read<T>(segment, regs[SI]));
+   regs[SI] += stringStep<T>();
+   regs[DI] += stringStep<T>();
+}
+
+template<typename T>
+void I8086::stos() {
+   write<T>(segRegs.ES, regs[DI], accumulator<T>());
+   regs[DI] += stringStep<T>();
+}
+
+template<typename T>
+void I8086::lods() {
+   accumulator<T>() = read<T>(segment, regs[SI]);
+   regs[SI] += stringStep<T>();
+}
+
+template<typename T>
+void I8086::cmps() {
+   alu.sub<T>(read<T>(segment, regs[SI]), read<T>(segRegs.ES, regs[DI]));
+   regs[SI] += stringStep<T>();
+   regs[DI] += stringStep<T>();
+}
+
+template<typename T>
+void I8086::scas() {
+   alu.sub<T>(accumulator<T>(), read<T>(segRegs.ES, regs[DI]));
+   regs[DI] += stringStep<T>();
+}
+
+template<typename T>
+void I8086::repMovs() {
+   const bool down = alu.flags.D;
+   byte* base = memory->data();
+
+   while (regs[CX] != 0) {
+      unsigned int n = std::min({ (unsigned int)regs[CX],
+         span<T>(segment, regs[SI], down),
+         span<T>(segRegs.ES, regs[DI], down) });
+      if (n == 0) { // this element wraps
+         movs<T>();
+         regs[CX]--;
+         continue;
+      }
+
+      const int bytes = n * sizeof(T);
+      int src = (segment << 4) + regs[SI];
+      int dst = (segRegs.ES << 4) + regs[DI];
+      if (down) { // lowest address of the block
+         src -= bytes - sizeof(T);
+         dst -= bytes - sizeof(T);
+      }
+      if (!memory->direct(src, bytes, false) || !memory->direct(dst, bytes, true)) { // ROM or a device
+         for (unsigned int i = 0; i < n; i++)
+            movs<T>();
+         regs[CX] -= n;
+         continue;
+      }
+      // How far the writes run ahead of the reads, in the direction of the copy.
+      // Between 0 and the block length, later elements read what earlier elements wrote.
+      const int lag = down ? src - dst : dst - src;
+
+      if (lag <= 0 || lag >= bytes) {
+         memmove(base + dst, base + src, bytes);
+      } else if (lag < (int)sizeof(T)) { // word copy one byte onto itself
+         for (unsigned int i = 0; i < n; i++)
+            movs<T>();
+         regs[CX] -= n;
+         continue;
+      } else {
+         // Chunks no longer than the lag only read bytes that earlier chunks have finished writing,
+         // which replicates the pattern exactly as the element by element copy does
+         const int chunk = lag / sizeof(T) * sizeof(T);
+         if (!down) {
+            for (int i = 0; i < bytes; i += chunk)
+               memcpy(base + dst + i, base + src + i, std::min(chunk, bytes - i));
+         } else {
+            for (int i = bytes; i > 0;) {
+               int length = std::min(chunk, i);
+               i -= length;
+               memcpy(base + dst + i, base + src + i, length);
+            }
+         }
+      }
+      memory->written(dst, bytes);
+
+      regs[SI] += n * stringStep<T>();
+      regs[DI] += n * stringStep<T>();
+      regs[CX] -= n;
+   }
+}
+
+template<typename T>
+void I8086::repStos() {
+   const bool down = alu.flags.D;
+   const T value = accumulator<T>();
+   byte* base = memory->data();
+
+   while (regs[CX] != 0) {
+      unsigned int n = std::min((unsigned int)regs[CX], span<T>(segRegs.ES, regs[DI], down));
+      if (n == 0) { // this element wraps
+         stos<T>();
+         regs[CX]--;
+         continue;
+      }
+
+      const int bytes = n * sizeof(T);
+      int dst = (segRegs.ES << 4) + regs[DI];
+      if (down) // lowest address of the block
+         dst -= bytes - sizeof(T);
+      if (!memory->direct(dst, bytes, true)) { // ROM or a device
+         for (unsigned int i = 0; i < n; i++)
+            stos<T>();
+         regs[CX] -= n;
+         continue;
+      }
+
+      if (sizeof(T) == 1 || (value & 0xff) == (value >> 8))
+         memset(base + dst, value & 0xff, bytes);
+      else // unaligned stores the compiler turns into wide vector stores
+         for (int i = 0; i < bytes; i += sizeof(T))
+            memcpy(base + dst + i, &value, sizeof(T));
+      memory->written(dst, bytes);
+
+      regs[DI] += n * stringStep<T>();
+      regs[CX] -= n;
+   }
+}
+
+template<typename T>
+void I8086::repLods() {
+   // Every element but the last is overwritten in the accumulator, so only the last one is loaded
+   if (regs[CX] == 0)
+      return;
+   regs[SI] += (regs[CX] - 1) * stringStep<T>();
+   lods<T>();
+   regs[CX] = 0;
+}
+
+template<typename T>
+void I8086::repCmps(bool whileEqual) {
+   const bool down = alu.flags.D;
+   const byte* base = memory->data();
+
+   while (regs[CX] != 0) {
+      unsigned int n = std::min({ (unsigned int)regs[CX],
+         span<T>(segment, regs[SI], down),
+         span<T>(segRegs.ES, regs[DI], down) });
+      int src = (segment << 4) + regs[SI];
+      int dst = (segRegs.ES << 4) + regs[DI];
+      if (down) { // lowest address of the block
+         src -= (n - 1) * sizeof(T);
+         dst -= (n - 1) * sizeof(T);
+      }
+      if (!memory->direct(src, n * sizeof(T), false) || !memory->direct(dst, n * sizeof(T), false))
+         n = 0; // a device is mapped there
+      if (n == 0) { // this element wraps
+         cmps<T>();
+         regs[CX]--;
+         if (alu.ZF() != whileEqual) return;
+         continue;
+      }
+      // REPE stops at the first mismatch, REPNE at the first match
+      unsigned int found = findElement<T>(base + src, base + dst, 0, n, !whileEqual, down);
+      unsigned int count = (found == n) ? n : (down ? n - found : found + 1);
+
+      // Skip to the last element compared and compare it again for the flags
+      regs[SI] += (count - 1) * stringStep<T>();
+      regs[DI] += (count - 1) * stringStep<T>();
+      cmps<T>();
+      regs[CX] -= count;
+      if (found != n) return;
+   }
+}
+
+template<typename T>
+void I8086::repScas(bool whileEqual) {
+   const bool down = alu.flags.D;
+   const T value = accumulator<T>();
+   const byte* base = memory->data();
+
+   while (regs[CX] != 0) {
+      unsigned int n = std::min((unsigned int)regs[CX], span<T>(segRegs.ES, regs[DI], down));
+      int dst = (segRegs.ES << 4) + regs[DI];
+      if (down) // lowest address of the block
+         dst -= (n - 1) * sizeof(T);
+      if (!memory->direct(dst, n * sizeof(T), false))
+         n = 0; // a device is mapped there
+      if (n == 0) { // this element wraps
+         scas<T>();
+         regs[CX]--;
+         if (alu.ZF() != whileEqual) return;
+         continue;
+      }
+      unsigned int found = findElement<T>(base + dst, nullptr, value, n, !whileEqual, down);
+      unsigned int count = (found == n) ? n : (down ? n - found : found + 1);
+
+      regs[DI] += (count - 1) * stringStep<T>();
+      scas<T>();
+      regs[CX] -= count;
+      if (found != n) return;
+   }
+}
+
+template void I8086::movs<byte>();
+template void I8086::movs<word>();
+template void I8086::stos<byte>();
+template void I8086::stos<word>();
+template void I8086::lods<byte>();
+template void I8086::lods<word>();
+template void I8086::cmps<byte>();
+template void I8086::cmps<word>();
+template void I8086::scas<byte>();
+template void I8086::scas<word>();
+template void I8086::repMovs<byte>();
+template void I8086::repMovs<word>();
+template void I8086::repStos<byte>();
+template void I8086::repStos<word>();
+template void I8086::repLods<byte>();
+template void I8086::repLods<word>();
+template void I8086::repCmps<byte>(bool);
+template void I8086::repCmps<word>(bool);
+template void I8086::repScas<byte>(bool);
+template void I8086::repScas<word>(bool);
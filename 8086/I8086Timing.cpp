@@ -0,0 +1,86 @@
+#include "I8086.h"
+
+#include <array>
+#include <iterator>
+
+// Instruction timing (8086 Family Table 2-21: Instruction Set Reference Data).
+// What an instruction costs apart from its data is known when it is decoded: the clocks of its form,
+// the effective address calculation and its prefixes. That is kept with the decoded instruction and is all
+// Timing::Approximate charges; Timing::Exact adds what depends on the data as the instruction executes.
+
+namespace {
+   // Clocks of the register (or only) form and of the memory form, without the effective address
+   struct Clocks { byte reg, mem; };
+   constexpr Clocks _ = { 3, 3 }; // not used; as NOP
+
+   constexpr Clocks forms[256] = {
+   // 0 ADD/OR
+      {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {10,10}, {8,8},                                {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {10,10}, _,
+   // 1 ADC/SBB
+      {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {10,10}, {8,8},                                {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {10,10}, {8,8},
+   // 2 AND/SUB, ES: DAA CS: DAS
+      {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {2,2}, {4,4},                                  {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {2,2}, {4,4},
+   // 3 XOR/CMP, SS: AAA DS: AAS
+      {3,16}, {3,16}, {3,9}, {3,9}, {4,4}, {4,4}, {2,2}, {4,4},                                  {3,9}, {3,9}, {3,9}, {3,9}, {4,4}, {4,4}, {2,2}, {4,4},
+   // 4 INC/DEC r16
+      {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2},                                    {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2},
+   // 5 PUSH/POP r16
+      {11,11}, {11,11}, {11,11}, {11,11}, {11,11}, {11,11}, {11,11}, {11,11},                    {8,8}, {8,8}, {8,8}, {8,8}, {8,8}, {8,8}, {8,8}, {8,8},
+   // 6
+      _, _, _, _, _, _, _, _,                                                                    _, _, _, _, _, _, _, _,
+   // 7 Jcc, taken
+      {16,16}, {16,16}, {16,16}, {16,16}, {16,16}, {16,16}, {16,16}, {16,16},                    {16,16}, {16,16}, {16,16}, {16,16}, {16,16}, {16,16}, {16,16}, {16,16},
+   // 8 immediate group (see groups), TEST XCHG MOV LEA POP
+      {4,17}, {4,17}, {4,17}, {4,17}, {3,9}, {3,9}, {4,17}, {4,17},                              {2,9}, {2,9}, {2,8}, {2,8}, {2,9}, {2,2}, {2,8}, {8,17},
+   // 9 NOP XCHG CBW CWD CALL far WAIT PUSHF POPF SAHF LAHF
+      {3,3}, {3,3}, {3,3}, {3,3}, {3,3}, {3,3}, {3,3}, {3,3},                                    {2,2}, {5,5}, {28,28}, {3,3}, {10,10}, {8,8}, {4,4}, {4,4},
+   // A MOV acc/mem, MOVS CMPS TEST STOS LODS SCAS (once; see repeated())
+      {10,10}, {10,10}, {10,10}, {10,10}, {18,18}, {18,18}, {22,22}, {22,22},                    {4,4}, {4,4}, {11,11}, {11,11}, {12,12}, {12,12}, {15,15}, {15,15},
+   // B MOV r,imm
+      {4,4}, {4,4}, {4,4}, {4,4}, {4,4}, {4,4}, {4,4}, {4,4},                                    {4,4}, {4,4}, {4,4}, {4,4}, {4,4}, {4,4}, {4,4}, {4,4},
+   // C RET LES LDS MOV RETF INT INTO (not taken) IRET
+      _, _, {12,12}, {8,8}, {16,16}, {16,16}, {4,10}, {4,10},                                    _, _, {17,17}, {18,18}, {52,52}, {51,51}, {4,4}, {24,24},
+   // D shift group (see groups) AAM AAD XLAT ESC
+      {2,15}, {2,15}, {12,24}, {12,24}, {83,83}, {60,60}, _, {11,11},                            {2,8}, {2,8}, {2,8}, {2,8}, {2,8}, {2,8}, {2,8}, {2,8},
+   // E LOOPNE LOOPE LOOP JCXZ (taken) IN OUT CALL JMP IN OUT
+      {19,19}, {18,18}, {17,17}, {18,18}, {10,10}, {10,10}, {10,10}, {10,10},                    {19,19}, {15,15}, {15,15}, {15,15}, {8,8}, {8,8}, {8,8}, {8,8},
+   // F LOCK REP HLT CMC unary group (see groups) CLC STC CLI STI CLD STD, INC/DEC group (see groups)
+      {2,2}, _, {2,2}, {2,2}, {2,2}, {2,2}, {5,11}, {5,11},                                      {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {2,2}, {3,15}, {3,15},
+   };
+
+   // Group opcodes by /ext. Shifts by CL are charged one bit; MUL and DIV the middle of their ranges
+   constexpr byte groupOpcodes[] = { 0x80, 0x81, 0x82, 0x83, 0xD0, 0xD1, 0xD2, 0xD3, 0xF6, 0xF7, 0xFE, 0xFF };
+   constexpr Clocks immediate[8] = { {4,17}, {4,17}, {4,17}, {4,17}, {4,17}, {4,17}, {4,17}, {4,10} }; // ADD OR ADC SBB AND SUB XOR CMP
+   constexpr Clocks groups[std::size(groupOpcodes)][8] = {
+      { immediate[0], immediate[1], immediate[2], immediate[3], immediate[4], immediate[5], immediate[6], immediate[7] },
+      { immediate[0], immediate[1], immediate[2], immediate[3], immediate[4], immediate[5], immediate[6], immediate[7] },
+      { immediate[0], immediate[1], immediate[2], immediate[3], immediate[4], immediate[5], immediate[6], immediate[7] },
+      { immediate[0], immediate[1], immediate[2], immediate[3], immediate[4], immediate[5], immediate[6], immediate[7] },
+      { {2,15}, {2,15}, {2,15}, {2,15}, {2,15}, {2,15}, {2,15}, {2,15} }, // shift r/m8,1
+      { {2,15}, {2,15}, {2,15}, {2,15}, {2,15}, {2,15}, {2,15}, {2,15} }, // shift r/m16,1
+      { {12,24}, {12,24}, {12,24}, {12,24}, {12,24}, {12,24}, {12,24}, {12,24} }, // shift r/m8,CL: 8+4/bit, 20+4/bit
+      { {12,24}, {12,24}, {12,24}, {12,24}, {12,24}, {12,24}, {12,24}, {12,24} }, // shift r/m16,CL
+      { {5,11}, {5,11}, {3,16}, {3,16}, {74,80}, {89,95}, {85,91}, {107,113} },    // TEST - NOT NEG MUL IMUL DIV IDIV r/m8
+      { {5,11}, {5,11}, {3,16}, {3,16}, {126,132}, {141,147}, {153,159}, {175,181} }, // r/m16
+      { {3,15}, {3,15}, _, _, _, _, _, _ },                                      // INC DEC r/m8
+      { {3,15}, {3,15}, {16,21}, {37,37}, {11,18}, {24,24}, {11,16}, _ },        // INC DEC CALL CALL far JMP JMP far PUSH
+   };
+}
+
+word I8086::clocks(byte opcode, byte modrm, bool hasModRM, bool repeated) {
+   static constexpr auto groupIndex = [] {
+      std::array<signed char, 256> index{};
+      for (auto& i : index) i = -1;
+      for (size_t i = 0; i < std::size(groupOpcodes); i++) index[groupOpcodes[i]] = (signed char)i;
+      return index;
+   }();
+
+   // REP MOVS, CMPS, SCAS, LODS and STOS: 9, with the REP prefix, and the elements (see repeated())
+   if (repeated && ((opcode >= 0xA4 && opcode <= 0xA7) || (opcode >= 0xAA && opcode <= 0xAF)))
+      return 9;
+
+   const Clocks& form = groupIndex[opcode] >= 0 ? groups[groupIndex[opcode]][(modrm >> 3) & 7] : forms[opcode];
+   if (!hasModRM || modrmTable[modrm].isRegister)
+      return form.reg;
+   return form.mem + modrmTable[modrm].eaClocks;
+}
@@ -1,317 +1,687 @@
 #include "I8087.h"
+#include <cmath>
+#include <cstring>
 
+// Host double: the arithmetic is the host's; exceptions are worked out from the operands and the result
+template<> struct Arithmetic<double> {
+   static double checked(double result, double a, double b, FloatEnvironment& environment) {
+      if (std::isnan(result) && !std::isnan(a) && !std::isnan(b))
+         environment.exceptions |= Exception::Invalid;
+      else if (std::isinf(result) && std::isfinite(a) && std::isfinite(b))
+         environment.exceptions |= Exception::Overflow | Exception::Precision;
+      return result;
+   }
+   static double add(double a, double b, FloatEnvironment& environment) { return checked(a + b, a, b, environment); }
+   static double subtract(double a, double b, FloatEnvironment& environment) { return checked(a - b, a, b, environment); }
+   static double multiply(double a, double b, FloatEnvironment& environment) { return checked(a * b, a, b, environment); }
+   static double divide(double a, double b, FloatEnvironment& environment) {
+      if (b == 0 && a != 0 && std::isfinite(a)) {
+         environment.exceptions |= Exception::ZeroDivide;
+         return a / b;
+      }
+      return checked(a / b, a, b, environment);
+   }
+   static double squareRoot(double a, FloatEnvironment& environment) {
+      if (a < 0) {
+         environment.exceptions |= Exception::Invalid;
+         return indefinite();
+      }
+      return std::sqrt(a);
+   }
+   static int compare(double a, double b, FloatEnvironment& environment) {
+      if (std::isnan(a) || std::isnan(b)) {
+         environment.exceptions |= Exception::Invalid;
+         return 2;
+      }
+      return a < b ? -1 : a > b ? 1 : 0;
+   }
+   static double negate(double a) { return -a; }
+   static double absolute(double a) { return std::fabs(a); }
+   static bool negative(double a) { return std::signbit(a); }
+   static FloatClass classify(double a) {
+      switch (std::fpclassify(a)) {
+      case FP_ZERO:      return FloatClass::Zero;
+      case FP_SUBNORMAL: return FloatClass::Denormal;
+      case FP_INFINITE:  return FloatClass::Infinity;
+      case FP_NAN:       return FloatClass::NaN;
+      default:           return FloatClass::Normal;
+      }
+   }
+
+   static double roundToInteger(double a, FloatEnvironment& environment) {
+      double rounded;
+      switch (environment.rounding) {
+      case Rounding::Down: rounded = std::floor(a); break;
+      case Rounding::Up:   rounded = std::ceil(a); break;
+      case Rounding::Chop: rounded = std::trunc(a); break;
+      default:             rounded = std::nearbyint(a); break;
+      }
+      if (rounded != a && !std::isnan(a))
+         environment.exceptions |= Exception::Precision;
+      return rounded;
+   }
+   static double scale(double a, double b, FloatEnvironment& environment) {
+      if (std::isnan(a) || std::isnan(b))
+         return a + b;
+      const double n = std::trunc(b);
+      return checked(std::ldexp(a, n < -100'000 ? -100'000 : n > 100'000 ? 100'000 : (int)n), a, 0, environment);
+   }
+   static void extract(double a, double& exponent, double& significand, FloatEnvironment& environment) {
+      if (a == 0) {
+         environment.exceptions |= Exception::ZeroDivide;
+         exponent = -INFINITY;
+         significand = a;
+      } else if (!std::isfinite(a)) {
+         exponent = std::isnan(a) ? a : INFINITY;
+         significand = a;
+      } else {
+         int n;
+         significand = std::frexp(a, &n) * 2;
+         exponent = n - 1;
+      }
+   }
+   static double remainder(double a, double b, int& quotient, bool& complete, FloatEnvironment& environment) {
+      quotient = 0;
+      complete = true;
+      if (std::isnan(a) || std::isnan(b))
+         return a + b;
+      if (std::isinf(a) || b == 0) {
+         environment.exceptions |= Exception::Invalid;
+         return indefinite();
+      }
+      const double r = std::fmod(a, b);
+      const double eight = std::fmod(a, 8 * b); // a multiple of b from r: the quotient's low 3 bits
+      if (std::isfinite(eight))
+         quotient = (int)std::lround(std::fabs((eight - r) / b)) & 7;
+      return r;
+   }
+
+   static double fromInteger(int64_t value) { return (double)value; }
+   static int64_t toInteger(double a, FloatEnvironment& environment) {
+      const double rounded = roundToInteger(a, environment);
+      if (std::isnan(rounded) || rounded >= 9223372036854775808.0 || rounded < -9223372036854775808.0) {
+         environment.exceptions |= Exception::Invalid;
+         return INT64_MIN;
+      }
+      return (int64_t)rounded;
+   }
+   static double fromSingle(uint32_t bits, FloatEnvironment&) {
+      float value;
+      memcpy(&value, &bits, sizeof value);
+      return value;
+   }
+   static double fromDouble(uint64_t bits, FloatEnvironment&) {
+      double value;
+      memcpy(&value, &bits, sizeof value);
+      return value;
+   }
+   static double fromTemporary(const byte* bytes) { return Arithmetic<Extended>::toHost(Arithmetic<Extended>::fromTemporary(bytes)); }
+   static uint32_t toSingle(double a, FloatEnvironment& environment) {
+      const float value = (float)checked(a, a, 0, environment);
+      if (std::isinf(value) && std::isfinite(a))
+         environment.exceptions |= Exception::Overflow | Exception::Precision;
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof bits);
+      return bits;
+   }
+   static uint64_t toDouble(double a, FloatEnvironment&) {
+      uint64_t bits;
+      memcpy(&bits, &a, sizeof bits);
+      return bits;
+   }
+   static void toTemporary(double a, byte* bytes) { Arithmetic<Extended>::toTemporary(Arithmetic<Extended>::fromHost(a), bytes); }
+   static double fromHost(double value) { return value; }
+   static double toHost(double a) { return a; }
+
+   static double indefinite() { return -NAN; } // sign set, quiet bit set: 0xFFF8000000000000
+   static double constant(int index) {
+      static constexpr double constants[7] = {
+         1, 3.32192809488736234787, 1.44269504088896340736, 3.14159265358979323846,
+         0.301029995663981195214, 0.693147180559945309417, 0
+      };
+      return constants[index];
+   }
+};
+
+template<typename Real>
+I8087<Real>::I8087(Memory* memory) : memory(memory) {
+   reset();
+}
+
+// FINIT: as after RESET (8086 Family Table 3-17)
+template<typename Real>
+void I8087<Real>::reset() {
+   controlWord = 0x03FF; // all exceptions masked, 64-bit precision, round to nearest, projective infinity
+   statusWord = 0;
+   top = 0;
+   for (int i = 0; i < 8; i++) {
+      registers[i] = A::constant(6);
+      tags[i] = EMPTY;
+   }
+   instructionPointer = operandPointer = 0;
+   lastOpcode = 0;
+}
+
+template<typename Real>
+word I8087<Real>::tag() const {
+   word tagWord = 0;
+   for (int i = 0; i < 8; i++)
+      tagWord |= tags[i] << (2 * i);
+   return tagWord;
+}
+
+template<typename Real>
+FloatEnvironment I8087<Real>::controlEnvironment() const {
+   static constexpr int precision[4] = { 24, 64, 53, 64 }; // PC 01 is reserved
+   return { precision[controlWord >> 8 & 3], (Rounding)(controlWord >> 10 & 3), 0 };
+}
+
+template<typename Real>
+bool I8087<Real>::masked(const FloatEnvironment& environment) const {
+   return !(environment.exceptions & ~controlWord & (0x3F & ~Exception::Precision));
+}
+
+template<typename Real>
+void I8087<Real>::raise(const FloatEnvironment& environment) {
+   statusWord |= environment.exceptions;
+   if (environment.exceptions & ~controlWord & 0x3F)
+      statusWord |= IR;
+}
 
+template<typename Real>
+Real I8087<Real>::get(int i, FloatEnvironment& environment) const {
+   if (tags[index(i)] == EMPTY) {
+      environment.exceptions |= Exception::Invalid;
+      return A::indefinite();
+   }
+   return registers[index(i)];
+}
+
+template<typename Real>
+void I8087<Real>::set(int i, Real value) {
+   registers[index(i)] = value;
+   tags[index(i)] = tagOf(value);
+}
+
+template<typename Real>
+void I8087<Real>::push(Real value, FloatEnvironment& environment) {
+   if (tags[index(-1)] != EMPTY) { // stack overflow
+      environment.exceptions |= Exception::Invalid;
+      if (!masked(environment))
+         return;
+      value = A::indefinite();
+   }
+   top = index(-1);
+   set(0, value);
+}
+
+template<typename Real>
+void I8087<Real>::pop() {
+   tags[top] = EMPTY;
+   top = index(1);
+}
+
+template<typename Real>
+typename I8087<Real>::Tag I8087<Real>::tagOf(Real value) {
+   switch (A::classify(value)) {
+   case FloatClass::Zero:   return ZERO;
+   case FloatClass::Normal: return VALID;
+   default:                 return SPECIAL;
+   }
+}
+
+template<typename Real>
+Real I8087<Real>::load(int format, int address, FloatEnvironment& environment) {
+   switch (format) {
+   case 0:  return A::fromSingle(read<uint32_t>(address), environment);
+   case 1:  return A::fromInteger(read<int32_t>(address));
+   case 2:  return A::fromDouble(read<uint64_t>(address), environment);
+   default: return A::fromInteger(read<int16_t>(address));
+   }
+}
 
-I8087::I8087()
-{
+// Operands longer than a word are read and written a byte at a time, with the 20-bit address wrapping
+template<typename Real>
+void I8087<Real>::readBytes(int address, byte* bytes, int length) const {
+   for (int i = 0; i < length; i++)
+      bytes[i] = memory->read<byte>((address + i) & 0xF'FFFF);
 }
 
+template<typename Real>
+void I8087<Real>::writeBytes(int address, const byte* bytes, int length) {
+   for (int i = 0; i < length; i++)
+      memory->write<byte>((address + i) & 0xF'FFFF, bytes[i]);
+}
 
-I8087::~I8087()
-{
+template<typename Real>
+void I8087<Real>::arithmetic(int ext, int destination, Real b, FloatEnvironment& environment) {
+   const Real a = get(0, environment);
+   Real result;
+   switch (ext) {
+   case 0: result = A::add(a, b, environment); break;
+   case 1: result = A::multiply(a, b, environment); break;
+   case 2:
+   case 3: compare(a, b, environment); return;
+   case 4: result = A::subtract(a, b, environment); break;
+   case 5: result = A::subtract(b, a, environment); break;
+   case 6: result = A::divide(a, b, environment); break;
+   default: result = A::divide(b, a, environment); break;
+   }
+   if (masked(environment))
+      set(destination, result);
 }
 
-void I8087::run(byte opcode, byte ModRegRM) {
-   int mod = (ModRegRM >> 5) & 0b11;
-   int ext = (ModRegRM >> 2) & 0b111;
-   int rm = (ModRegRM >> 0) & 0b111;
+template<typename Real>
+void I8087<Real>::compare(Real a, Real b, FloatEnvironment& environment) {
+   switch (A::compare(a, b, environment)) {
+   case -1: conditions(C0); break;
+   case 0:  conditions(C3); break;
+   case 1:  conditions(0); break;
+   default: conditions(C3 | C2 | C0); break; // unordered
+   }
+}
 
-   if (opcode == 0x9b) {
-      // CPU Wait for 807
+template<typename Real>
+void I8087<Real>::storeInteger(int size, int address, bool thenPop, FloatEnvironment& environment) {
+   int64_t value = A::toInteger(get(0, environment), environment);
+   const int64_t limit = 1ll << (size * 8 - 1);
+   if (value < -limit || value >= limit) {
+      environment.exceptions |= Exception::Invalid;
+      value = -limit; // the integer indefinite
+   }
+   if (!masked(environment))
+      return;
+   switch (size) {
+   case 2:  write<int16_t>(address, (int16_t)value); break;
+   case 4:  write<int32_t>(address, (int32_t)value); break;
+   default: write<int64_t>(address, value); break;
+   }
+   if (thenPop)
+      pop();
+}
+
+// Packed decimal: 18 digits, two to a byte with the least significant byte first, then the sign in bit 7
+// of the tenth byte
+template<typename Real>
+void I8087<Real>::loadBcd(int address, FloatEnvironment& environment) {
+   byte bytes[10];
+   readBytes(address, bytes, 10);
+   int64_t value = 0;
+   for (int i = 8; i >= 0; i--)
+      value = value * 100 + (bytes[i] >> 4) * 10 + (bytes[i] & 0x0F);
+   push(A::fromInteger(bytes[9] & 0x80 ? -value : value), environment);
+}
+
+template<typename Real>
+void I8087<Real>::storeBcd(int address, FloatEnvironment& environment) {
+   constexpr int64_t LIMIT = 999'999'999'999'999'999;
+   const int64_t value = A::toInteger(get(0, environment), environment);
+   byte bytes[10] = { 0, 0, 0, 0, 0, 0, 0, 0xC0, 0xFF, 0xFF }; // the decimal indefinite
+   if (value < -LIMIT || value > LIMIT) {
+      environment.exceptions |= Exception::Invalid;
    } else {
-      opcode &= 0b111; // Only botton three bits are used
-      switch (opcode & 1) {
-      case 0: // - - 0 | - - - - - - - -
-         switch (ext) { // if MOD=11, use ST(i) in place of R/M
-         case 0b000: // - - 0 | - - 0 0 0 - - -
-            // FADD = Addition
-            // ESCAPE  MF 0 | MOD 0 0 0 R/M   | DISP     Integer/Real memory with ST(0)
-            // ESCAPE d P 0 | 1 1 0 0 0 ST(i)            ST(i) and ST(0)
-            break;
-         case 0b001: // - - 0 | - - 0 0 1 - - -
-            // FMUL = Multiplication
-            // ESCAPE  MF 0 | MOD 0 0 1 R/M   | DISP     Integer/Real memory with ST(0)
-            // ESCAPE d P 0 | 1 1 0 0 1 ST(i)            ST(i) and ST(0)
-            break;
-         case 0b010: // - - 0 | - - 0 1 0 - - -
-            // FCOM = Compare
-            // ESCAPE  MF 0 | MOD 0 1 0 R/M   | DISP     Integer/Real memory to ST(0)
-            // ESCAPE 0 0 0 | 1 1 0 1 0 ST(i)            ST(i) to ST(0)
-            break;
-         case 0b011: // - - 0 | - - 0 1 1 - - -
-            // FCOMPP = Compare ST(1) to ST(0) and Pop Twice
-            // ESCAPE 1 1 0 | 1 1 0 1 1 0 0 1
+      uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+      for (int i = 0; i < 9; i++, magnitude /= 100)
+         bytes[i] = (byte)(magnitude % 100 / 10 << 4 | magnitude % 10);
+      bytes[9] = value < 0 ? 0x80 : 0;
+   }
+   if (!masked(environment))
+      return;
+   writeBytes(address, bytes, 10);
+   pop();
+}
+
+// The environment (8086 Family Figure 3-13): control, status and tag words, then the instruction and
+// operand pointers, 20 bits each with the opcode's 11 bits beside the instruction pointer's top 4
+template<typename Real>
+void I8087<Real>::storeEnvironment(int address) {
+   const word words[7] = {
+      controlWord, status(), tag(),
+      (word)instructionPointer, (word)((instructionPointer >> 16 & 0xF) << 12 | (lastOpcode & 0x7FF)),
+      (word)operandPointer, (word)((operandPointer >> 16 & 0xF) << 12)
+   };
+   byte bytes[14];
+   memcpy(bytes, words, sizeof bytes);
+   writeBytes(address, bytes, sizeof bytes);
+}
+
+template<typename Real>
+void I8087<Real>::loadEnvironment(int address) {
+   byte bytes[14];
+   word words[7];
+   readBytes(address, bytes, sizeof bytes);
+   memcpy(words, bytes, sizeof bytes);
+   controlWord = words[0];
+   statusWord = words[1] & ~0x3800;
+   top = words[1] >> 11 & 7;
+   for (int i = 0; i < 8; i++)
+      tags[i] = (Tag)(words[2] >> (2 * i) & 3);
+   instructionPointer = (words[4] >> 12) << 16 | words[3];
+   lastOpcode = words[4] & 0x7FF;
+   operandPointer = (words[6] >> 12) << 16 | words[5];
+}
+
+// FXAM: C3 C2 C0 the class of ST(0), C1 its sign (8086 Family Table 3-15)
+template<typename Real>
+void I8087<Real>::examine() {
+   const Real value = registers[top];
+   word codes = A::negative(value) ? C1 : 0;
+   if (tags[top] == EMPTY)
+      codes |= C3 | C0;
+   else switch (A::classify(value)) {
+   case FloatClass::Zero:     codes |= C3; break;
+   case FloatClass::Denormal: codes |= C3 | C2; break;
+   case FloatClass::Normal:   codes |= C2; break;
+   case FloatClass::Infinity: codes |= C2 | C0; break;
+   case FloatClass::NaN:      codes |= C0; break;
+   }
+   conditions(codes);
+}
+
+template<typename Real>
+void I8087<Real>::transcendental(byte ModRegRM, FloatEnvironment& environment) {
+   constexpr double LN2 = 0.693147180559945309417;
+   const Real x = get(0, environment);
+   const double h = A::toHost(x);
+   switch (ModRegRM) {
+   case 0b11'110'000: // F2XM1 = 2^(ST(0)) - 1
+      if (masked(environment))
+         set(0, A::fromHost(std::expm1(h * LN2)));
+      break;
+   case 0b11'110'001: // FYL2X = ST(1) * Log2(ST(0)), popped
+   case 0b11'111'001: // FYL2XP1 = ST(1) * Log2(ST(0)+1), popped
+   {
+      const double y = A::toHost(get(1, environment));
+      const bool plusOne = ModRegRM == 0b11'111'001;
+      if (plusOne ? h < -1 : h < 0)
+         environment.exceptions |= Exception::Invalid;
+      else if (plusOne ? h == -1 : h == 0)
+         environment.exceptions |= Exception::ZeroDivide;
+      if (masked(environment)) {
+         set(1, A::fromHost(y * (plusOne ? std::log1p(h) / LN2 : std::log2(h))));
+         pop();
+      }
+      break;
+   }
+   case 0b11'110'010: // FPTAN = Partial Tangent of ST(0): Y / X, with X 1
+      if (masked(environment)) {
+         set(0, A::fromHost(std::tan(h)));
+         push(A::constant(0), environment);
+      }
+      break;
+   case 0b11'110'011: // FPATAN = Partial Arctangent of ST(1) / ST(0), popped
+   {
+      const double y = A::toHost(get(1, environment));
+      if (masked(environment)) {
+         set(1, A::fromHost(std::atan2(y, h)));
+         pop();
+      }
+      break;
+   }
+   case 0b11'110'100: // FXTRACT = Extract Components of ST(0): exponent, then the significand pushed
+   {
+      Real exponent, significand;
+      A::extract(x, exponent, significand, environment);
+      if (masked(environment)) {
+         set(0, exponent);
+         push(significand, environment);
+      }
+      break;
+   }
+   case 0b11'110'110: // FDECSTP = Decrement Stack Pointer
+      top = index(-1);
+      break;
+   case 0b11'110'111: // FINCSTP = Increment Stack Pointer
+      top = index(1);
+      break;
+   case 0b11'111'000: // FPREM = Partial Remainder of ST(0) / ST(1): C0 C3 C1 the quotient's low bits, C2 incomplete
+   {
+      int quotient;
+      bool complete;
+      const Real remainder = A::remainder(x, get(1, environment), quotient, complete, environment);
+      if (masked(environment)) {
+         set(0, remainder);
+         conditions(!complete ? (word)C2 : (word)((quotient & 4 ? C0 : 0) | (quotient & 2 ? C3 : 0) | (quotient & 1 ? C1 : 0)));
+      }
+      break;
+   }
+   case 0b11'111'010: // FSQRT = Square Root of ST(0)
+   {
+      const Real root = A::squareRoot(x, environment);
+      if (masked(environment))
+         set(0, root);
+      break;
+   }
+   case 0b11'111'100: // FRNDINT = Round ST(0) to Integer
+   {
+      const Real rounded = A::roundToInteger(x, environment);
+      if (masked(environment))
+         set(0, rounded);
+      break;
+   }
+   case 0b11'111'101: // FSCALE = Scale ST(0) by ST(1)
+   {
+      const Real scaled = A::scale(x, get(1, environment), environment);
+      if (masked(environment))
+         set(0, scaled);
+      break;
+   }
+   }
+}
 
-            // FCOMP = Compare and Pop
-            // ESCAPE  MF 0 | MOD 0 1 1 R/M   | DISP     Integer/Real memory to ST(0)
-            // ESCAPE 0 0 0 | 1 1 0 1 1 ST(i)            ST(i) to ST(0)
+template<typename Real>
+void I8087<Real>::run(byte opcode, byte ModRegRM, int address, int instruction) {
+   const int mod = (ModRegRM >> 6) & 0b11;
+   const int ext = (ModRegRM >> 3) & 0b111;
+   const int rm = (ModRegRM >> 0) & 0b111;
+   opcode &= 0b111; // Only bottom three bits are used
+   const int format = opcode >> 1; // MF: short real, short integer, long real, word integer
+
+   FloatEnvironment environment = controlEnvironment();
+   bool control = false; // control instructions leave the instruction and operand pointers as they were
+   if (mod != 0b11) {
+      switch (opcode) {
+      case 0b000: // ESCAPE MF 0 | MOD ext R/M: FADD FMUL FCOM FCOMP FSUB FSUBR FDIV FDIVR ST(0) and memory
+      case 0b010:
+      case 0b100:
+      case 0b110:
+         arithmetic(ext, 0, load(format, address, environment), environment);
+         if (ext == 0b011 && masked(environment))
+            pop();
+         break;
+      case 0b001: // ESCAPE 0 0 1: short real, environment and control word
+         switch (ext) {
+         case 0b000: push(load(format, address, environment), environment); break; // FLD
+         case 0b010: // FST, FSTP
+         case 0b011:
+         {
+            const uint32_t value = A::toSingle(get(0, environment), environment);
+            if (!masked(environment))
+               break;
+            write<uint32_t>(address, value);
+            if (ext == 0b011)
+               pop();
             break;
-         case 0b100: // - - 0 | - - 1 0 0 - - -
-         case 0b101: // - - 0 | - - 1 0 1 - - -
-            // FSUB = Subtraction
-            // ESCAPE  MF 0 | MOD 1 0 R R/M   | DISP     Integer/Real memory with ST(0)
-            // ESCAPE d P 0 | 1 1 1 0 R ST(i)            ST(i) and ST(0)
+         }
+         case 0b100: loadEnvironment(address); control = true; break;                 // FLDENV
+         case 0b101: controlWord = read<word>(address); control = true; break;        // FLDCW
+         case 0b110: storeEnvironment(address); control = true; break;                // FSTENV
+         case 0b111: write<word>(address, controlWord); control = true; break;        // FSTCW
+         }
+         break;
+      case 0b011: // ESCAPE 0 1 1: short integer, temporary real
+         switch (ext) {
+         case 0b000: push(load(format, address, environment), environment); break; // FILD
+         case 0b010: storeInteger(4, address, false, environment); break;           // FIST
+         case 0b011: storeInteger(4, address, true, environment); break;            // FISTP
+         case 0b101: // FLD temporary real
+         {
+            byte bytes[10];
+            readBytes(address, bytes, 10);
+            push(A::fromTemporary(bytes), environment);
             break;
-         case 0b110: // - - 0 | - - 1 1 0 - - -
-         case 0b111: // - - 0 | - - 1 1 1 - - -
-            // FDIV = Division
-            // ESCAPE  MF 0 | MOD 1 1 R R/M   | DISP     Integer/Real memory with ST(0)
-            // ESCAPE d P 0 | 1 1 1 1 R ST(i)            ST(i) and ST(0)
+         }
+         case 0b111: // FSTP temporary real
+         {
+            byte bytes[10];
+            A::toTemporary(get(0, environment), bytes);
+            if (!masked(environment))
+               break;
+            writeBytes(address, bytes, 10);
+            pop();
             break;
          }
+         }
          break;
-      case 1: // - - 1 | - - - - - - - -
+      case 0b101: // ESCAPE 1 0 1: long real, state and status word
          switch (ext) {
-         case 0b000: // - - 1 | - - 0 0 0 - - -
-            if ((opcode == 0b101) && (mod == 0b11)) {
-               // FFREE = Free ST(i)
-               // ESCAPE 1 0 1 | 1 1 0 0 0 ST(i)
-            } else {
-               // FLD = LOAD
-               // ESCAPE  MF 1 | MOD 0 0 0 R/M   | DISP     Integer/Real memory to ST(0)
-               // ESCAPE 0 0 1 | 1 1 0 0 0 ST(i) |          ST(i) to ST(0)
-            }
+         case 0b000: push(load(format, address, environment), environment); break; // FLD
+         case 0b010: // FST, FSTP
+         case 0b011:
+         {
+            const uint64_t value = A::toDouble(get(0, environment), environment);
+            if (!masked(environment))
+               break;
+            write<uint64_t>(address, value);
+            if (ext == 0b011)
+               pop();
             break;
-         case 0b001: // - - 1 | - - 0 0 1 - - -
-            if ((opcode == 0b001) && (mod == 0b11)) {
-               // FXCH = Exchange ST(i) and ST(0)
-               // ESCAPE 0 0 1 | 1 1 0 0 1 ST(i)            ST(i) and ST(0)
+         }
+         case 0b100: // FRSTOR = Restore State: the environment, then ST(0)-ST(7)
+         {
+            loadEnvironment(address);
+            byte bytes[10];
+            for (int i = 0; i < 8; i++) {
+               readBytes(address + 14 + i * 10, bytes, 10);
+               registers[index(i)] = A::fromTemporary(bytes);
             }
-            // Unused
-            // ESCAPE 0 0 1 | 0 0 0 0 1 - - -
-            // ESCAPE 0 0 1 | 0 1 0 0 1 - - -
-            // ESCAPE 0 0 1 | 1 0 0 0 1 - - -
-
-            // Unused
-            // ESCAPE 0 1 1 | - - 0 0 1 - - -
-            // ESCAPE 1 0 1 | - - 0 0 1 - - -
-            // ESCAPE 1 1 1 | - - 0 0 1 - - -
+            control = true;
             break;
-         case 0b010: // - - 1 | - - 0 1 0 - - -
-            if ((opcode == 0b001) && (ModRegRM == 0b1101'0000)) {
-               // FNOP = No Operation
-               // ESCAPE 0 0 1 | 1 1 0 1 0 0 0 0
-            } else {
-               // FST = STORE
-               // ESCAPE  MF 1 | MOD 0 1 0 R/M   | DISP     ST(0) to Integer/Real Memory
-               // ESCAPE 1 0 1 | 1 1 0 1 0 ST(i)            ST(0) to ST(i)
+         }
+         case 0b110: // FSAVE = Save State, then FINIT
+         {
+            storeEnvironment(address);
+            byte bytes[10];
+            for (int i = 0; i < 8; i++) {
+               A::toTemporary(registers[index(i)], bytes);
+               writeBytes(address + 14 + i * 10, bytes, 10);
             }
+            reset();
+            control = true;
             break;
-         case 0b011: // - - 1 | - - 0 1 1 - - -
-            // FSTP = STORE AND POP
-            // ESCAPE  MF 1 | MOD 0 1 1 R/M   | DISP     ST(0) to Integer/Real Memory
-            // ESCAPE 1 0 1 | 1 1 0 1 1 ST(i)            ST(0) to ST(i)
-            break;
-         case 0b100: // - - 1 | - - 1 0 0 - - -
-            switch (opcode) {
-            case 0b001: // 0 0 1 | - - 1 0 0 - - -
-               switch (ModRegRM) {
-               case 0b11'100'000:
-                  // FCHS = Change Sign of ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 0 0 0 0
-                  break;
-               case 0b11'100'001:
-                  // FABS = Absolute Value of ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 0 0 0 1
-                  break;
-               case 0b11'100'100:
-                  // FTST = Test ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 0 1 0 0
-                  break;
-               case 0b11'100'101:
-                  // FXAM = Examine ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 0 1 0 1
-                  break;
-               default: // - - 1 | - - 1 0 0 - - -
-                  // FLDENV = Load Environment
-                  // ESCAPE 0 0 1 | MOD 1 0 0 R/M   | DISP
-                  break;
-               }
-               break;
-            case 0b011: // 0 1 1 | - - 1 0 0 - - -
-               switch (ModRegRM) {
-               case 0b11'100'000:
-                  // FENI = Enable Interrupts
-                  // ESCAPE 0 1 1 | 1 1 1 0 0 0 0 0
-                  break;
-               case 0b11'100'001:
-                  // FDISI = Disable Interrupts
-                  // ESCAPE 0 1 1 | 1 1 1 0 0 0 0 1
-                  break;
-               case 0b11'100'010:
-                  // FCLEX = Clear Exceptions
-                  // ESCAPE 0 1 1 | 1 1 1 0 0 0 1 0
-                  break;
-               case 0b11'100'011:
-                  // FINIT = Initialized 8087
-                  // ESCAPE 0 1 1 | 1 1 1 0 0 0 1 1
-                  break;
-               default: // 0 1 1 | - - 1 0 0 - - -
-                  // Unused
-                  // ESCAPE 0 1 1 | - - 1 0 0 1 - -
-                  break;
+         }
+         case 0b111: write<word>(address, status()); control = true; break; // FSTSW
+         }
+         break;
+      case 0b111: // ESCAPE 1 1 1: word integer, BCD, long integer
+         switch (ext) {
+         case 0b000: push(load(format, address, environment), environment); break; // FILD
+         case 0b010: storeInteger(2, address, false, environment); break;           // FIST
+         case 0b011: storeInteger(2, address, true, environment); break;            // FISTP
+         case 0b100: loadBcd(address, environment); break;                          // FBLD
+         case 0b101: push(A::fromInteger(read<int64_t>(address)), environment); break; // FILD long integer
+         case 0b110: storeBcd(address, environment); break;                         // FBSTP
+         case 0b111: storeInteger(8, address, true, environment); break;            // FISTP long integer
+         }
+         break;
+      }
+   } else {
+      switch (opcode) {
+      case 0b000: // ESCAPE 0 0 0 | 1 1 ext ST(i): ST(0) = ST(0) op ST(i)
+         arithmetic(ext, 0, get(rm, environment), environment);
+         if (ext == 0b011 && masked(environment))
+            pop();
+         break;
+      case 0b100: // ESCAPE 1 0 0 | 1 1 ext ST(i): ST(i) = ST(0) op ST(i), so FSUB (ext 101) is ST(i) - ST(0)
+         arithmetic(ext, rm, get(rm, environment), environment);
+         if (ext == 0b011 && masked(environment))
+            pop();
+         break;
+      case 0b110: // ESCAPE 1 1 0 | 1 1 ext ST(i): and pop
+         if (ext == 0b011) {
+            if (rm == 0b001) { // FCOMPP = Compare ST(1) to ST(0) and Pop Twice
+               compare(get(0, environment), get(1, environment), environment);
+               if (masked(environment)) {
+                  pop();
+                  pop();
                }
-               break;
-            case 0b101: // 1 0 1 | - - 1 0 0 - - -
-               // FRSTOR = Restore State
-               // ESCAPE 1 0 1 | MOD 1 0 0 R/M   | DISP
-               break;
-            case 0b111: // 1 1 1 | - - 1 0 0 - - -
-               // FLD = LOAD
-               // ESCAPE 1 1 1 | MOD 1 0 0 R/M   | DISP     BCD Memory to ST(0)
-               break;
             }
             break;
-         case 0b101: // - - 1 | - - 1 0 1 - - -
-            switch (opcode) {
-            case 0b001: // 0 0 1 | - - 1 0 1 - - -
-               switch (ModRegRM) {
-               case 0b11'101'000:
-                  // FLD1 = LOAD +1.0 into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 0 0 0
-                  break;
-               case 0b11'101'001:
-                  // FLDL2T = LOAD log2(10) into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 0 0 1
-                  break;
-               case 0b11'101'010:
-                  // FLD2E = LOAD log2(e) into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 0 1 0
-                  break;
-               case 0b11'101'011:
-                  // FLDPI = LOAD pi into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 0 1 1
-                  break;
-               case 0b11'101'100:
-                  // FLDLG2 = LOAD log10(2) into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 1 0 0
-                  break;
-               case 0b11'101'101:
-                  // FLDLN2 = LOAD loge(2) into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 1 0 1
-                  break;
-               case 0b11'101'110:
-                  // FLDZ = LOAD +0.0 into ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 0 1 1 1 0
-                  break;
-               default: // 0 0 1 | - - 1 0 1 - - -
-                  // FLDCW = Load Control Word
-                  // ESCAPE 0 0 1 | MOD 1 0 1 R/M   | DISP
-                  break;
-               }
-               break;
-            case 0b011: // 0 1 1 | - - 1 0 1 - - -
-               // FLD = LOAD
-               // ESCAPE 0 1 1 | MOD 1 0 1 R/M   | DISP     Temporary Real Memory to ST(0)
-               break;
-            case 0b111: // 1 1 1 | - - 1 0 1 - - -
-               // FLD = LOAD
-               // ESCAPE 1 1 1 | MOD 1 0 1 R/M   | DISP     Long Integer Memory to ST(0)
-               break;
-            case 0b101: // 1 0 1 | - - 1 0 1 - - -
-               // Unused
-               // ESCAPE 1 0 1 | - - 1 0 1 - - -
-               break;
+         }
+         arithmetic(ext, rm, get(rm, environment), environment);
+         if (masked(environment))
+            pop();
+         break;
+      case 0b001: // ESCAPE 0 0 1 | 1 1 ext ST(i)
+         switch (ext) {
+         case 0b000: // FLD ST(i)
+            push(get(rm, environment), environment);
+            break;
+         case 0b001: // FXCH = Exchange ST(i) and ST(0)
+         {
+            const Real a = get(0, environment), b = get(rm, environment);
+            if (masked(environment)) {
+               set(0, b);
+               set(rm, a);
             }
             break;
-         case 0b110: // - - 1 | - - 1 1 0 - - -
-            switch (opcode) {
-            case 0b001: // 0 0 1 | - - 1 1 0 - - -
-               switch (ModRegRM) {
-               case 0b11'110'000:
-                  // F2XM1 = 2^(ST(0)) - 1
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 0 0 0
-                  break;
-               case 0b11'110'001:
-                  // FYL2X = ST(1) * Log2(|ST(0)|)
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 0 0 1
-                  break;
-               case 0b11'110'010:
-                  // FPTAN = Partial Tangent of ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 0 1 0
-                  break;
-               case 0b11'110'011:
-                  // FPATAN = Partial Arctangent of ST(0) / ST(1)
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 0 1 1
-                  break;
-               case 0b11'110'100:
-                  // FXTRACT = Extract Components of ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 1 0 0
-                  break;
-               case 0b11'110'110:
-                  // FDECSTP = Decrement Stack Pointer
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 1 1 0
-                  break;
-               case 0b11'110'111:
-                  // FINCSTP = Increment Stack Pointer
-                  // ESCAPE 0 0 1 | 1 1 1 1 0 1 1 1
-                  break;
-               default: // 0 0 1 | - - 1 1 0 - - -
-                  // FSTENV = Store Environment
-                  // ESCAPE 0 0 1 | MOD 1 1 0 R/M   | DISP
-                  break;
-               }
-               break;
-            case 0b101: // 1 0 1 | - - 1 1 0 - - -
-               // FSAVE = Save State
-               // ESCAPE 1 0 1 | MOD 1 1 0 R/M   | DISP
-               break;
-            case 0b111: // 1 1 1 | - - 1 1 0 - - -
-               // FSTP = STORE AND POP
-               // ESCAPE 1 1 1 | MOD 1 1 0 R/M   | DISP     ST(0) to BCD Memory
-               break;
-            case 0b011: // 0 1 1 | - - 1 1 0 - - -
-               // Unused
-               // ESCAPE 0 1 1 | - - 1 1 0 - - -
-               break;
+         }
+         case 0b010: // FNOP
+            break;
+         case 0b011: // FSTP ST(i) (reserved encoding)
+            registers[index(rm)] = get(0, environment);
+            tags[index(rm)] = tags[top];
+            pop();
+            break;
+         case 0b100:
+            switch (rm) {
+            case 0b000: set(0, A::negate(get(0, environment))); break;   // FCHS
+            case 0b001: set(0, A::absolute(get(0, environment))); break; // FABS
+            case 0b100: compare(get(0, environment), A::constant(6), environment); break; // FTST
+            case 0b101: examine(); break;                                // FXAM
             }
             break;
-         case 0b111: // - - 1 | - - 1 1 1 - - -
-            switch (opcode) {
-            case 0b001: // 0 0 1 | - - 1 1 1 - - -
-               switch (ModRegRM) {
-               case 0b11'111'000:
-                  // FPREM = Partial Remainder of ST(0)+ST(1)
-                  // ESCAPE 0 0 1 | 1 1 1 1 1 0 0 0
-                  break;
-               case 0b11'111'001:
-                  // FYL2XP1 = ST(1) * Log2(ST(0)+1)
-                  // ESCAPE 0 0 1 | 1 1 1 1 1 0 0 1
-                  break;
-               case 0b11'111'010:
-                  // FSQRT = Square Root of ST(0)
-                  // ESCAPE 0 0 1 | 1 1 1 1 1 0 1 0
-                  break;
-               case 0b11'111'100:
-                  // FRNDINT = Rount ST(0) to Integer
-                  // ESCAPE 0 0 1 | 1 1 1 1 1 1 0 0
-                  break;
-               case 0b11'111'101:
-                  // FSCALE = Scale ST(0) by ST(1)
-                  // ESCAPE 0 0 1 | 1 1 1 1 1 1 0 1
-                  break;
-               default: // 0 0 1 | - - 1 1 1 - - -
-                  // FSTCW = Store Control Word
-                  // ESCAPE 0 0 1 | MOD 1 1 1 R/M   | DISP
-                  break;
-               }
-               break;
-            case 0b011: // 0 1 1 | - - 1 1 1 - - -
-               // FSTP = STORE AND POP
-               // ESCAPE 0 1 1 | MOD 1 1 1 R/M   | DISP     ST(0) to Temporary Real Memory
-               break;
-            case 0b101: // 1 0 1 | - - 1 1 1 - - -
-               // FSTSW = Store Status Word
-               // ESCAPE 1 0 1 | MOD 1 1 1 R/M   | DISP
-               break;
-            case 0b111: // 1 1 1 | - - 1 1 1 - - -
-               // FSTP = STORE AND POP
-               // ESCAPE 1 1 1 | MOD 1 1 1 R/M   | DISP     ST(0) to Long Integer Memory
-               break;
+         case 0b101: // FLD1 FLDL2T FLDL2E FLDPI FLDLG2 FLDLN2 FLDZ
+            if (rm != 0b111)
+               push(A::constant(rm), environment);
+            break;
+         default:
+            transcendental(ModRegRM, environment);
+            break;
+         }
+         break;
+      case 0b011: // ESCAPE 0 1 1 | 1 1 1 0 0 - - -
+         if (ext == 0b100) {
+            switch (rm) {
+            case 0b000: controlWord &= ~0x0080; break;                    // FENI = Enable Interrupts
+            case 0b001: controlWord |= 0x0080; break;                     // FDISI = Disable Interrupts
+            case 0b010: statusWord &= ~(0x003F | IR | BUSY); break;       // FCLEX = Clear Exceptions
+            case 0b011: reset(); break;                                   // FINIT = Initialize 8087
             }
+            control = true;
+         }
+         break;
+      case 0b101: // ESCAPE 1 0 1 | 1 1 ext ST(i)
+         switch (ext) {
+         case 0b000: tags[index(rm)] = EMPTY; break;             // FFREE
+         case 0b010: set(rm, get(0, environment)); break;        // FST ST(i)
+         case 0b011:                                             // FSTP ST(i)
+            set(rm, get(0, environment));
+            pop();
             break;
          }
          break;
       }
    }
-}
\ No newline at end of file
+
+   if (!control) {
+      instructionPointer = instruction;
+      if (mod != 0b11)
+         operandPointer = address;
+      lastOpcode = (word)(opcode << 8 | ModRegRM);
+   }
+   raise(environment);
+}
+
+template class I8087<double>;
+template class I8087<Extended>;
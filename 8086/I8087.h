@@ -1,10 +1,80 @@
 #pragma once
 #include "Common.h"
+#include "Extended.h"
+#include "Memory.h"
 
-class I8087 {
+// A numeric coprocessor on the 8086's local bus: it takes the ESC instructions the 8086 decodes
+class Coprocessor {
 public:
-   I8087();
-   ~I8087();
-   void run(byte opcode, byte ModRegRM);
+   virtual ~Coprocessor() {}
+   // ESC opcode (D8-DF) and its ModR/M byte; address is the physical address of a memory operand (-1 for
+   // the register forms) and instruction that of the instruction
+   virtual void run(byte opcode, byte ModRegRM, int address, int instruction) = 0;
+   virtual void reset() = 0; // FINIT
 };
 
+// 8087 Numeric Data Processor (8086 Family Chapter 3).
+// Its eight registers are kept as Real: double, for speed, or Extended, the 8087's own temporary real
+// calculated in software, for results identical to the chip's. Arithmetic<double> rounds as the host does,
+// to double precision and nearest, whatever the precision and rounding control; only FRNDINT, FIST and
+// FBSTP use the rounding control. The transcendental instructions are calculated by the host in double.
+// Exceptions set their flags in the status word; masked ones get the 8087's masked response, and an
+// unmasked one leaves the destination as it was and sets IR. The interrupt itself is not raised.
+template<typename Real>
+class I8087 : public Coprocessor {
+public:
+   explicit I8087(Memory* memory);
+
+   void run(byte opcode, byte ModRegRM, int address, int instruction) override;
+   void reset() override;
+
+   word control() const { return controlWord; }
+   word status() const { return (word)(statusWord | top << 11); }
+   word tag() const;
+   Real st(int i) const { return registers[(top + i) & 7]; }
+private:
+   typedef Arithmetic<Real> A;
+   enum Tag : byte { VALID, ZERO, SPECIAL, EMPTY };
+   // Status word
+   enum : word { IR = 0x0080, C0 = 0x0100, C1 = 0x0200, C2 = 0x0400, C3 = 0x4000, BUSY = 0x8000, CONDITIONS = C0 | C1 | C2 | C3 };
+
+   FloatEnvironment controlEnvironment() const; // precision and rounding control
+   // No exception of environment is unmasked, so the result is to be stored (an inexact result always is)
+   bool masked(const FloatEnvironment& environment) const;
+   void raise(const FloatEnvironment& environment); // into the status word, with IR if one is unmasked
+   void conditions(word codes) { statusWord = (word)((statusWord & ~CONDITIONS) | codes); }
+
+   int index(int i) const { return (top + i) & 7; } // physical register of ST(i)
+   Real get(int i, FloatEnvironment& environment) const; // ST(i); an empty register is an invalid operation
+   void set(int i, Real value);
+   void push(Real value, FloatEnvironment& environment);
+   void pop();
+   static Tag tagOf(Real value);
+
+   // Memory operands
+   template<typename T> T read(int address) const { return memory->read<T>(address); }
+   template<typename T> void write(int address, T value) { memory->write<T>(address, value); }
+   Real load(int format, int address, FloatEnvironment& environment); // by ESC opcode bits 2-1 (MF)
+   void readBytes(int address, byte* bytes, int length) const;
+   void writeBytes(int address, const byte* bytes, int length);
+
+   // FADD FMUL FCOM FCOMP FSUB FSUBR FDIV FDIVR (ext) of ST(0) and b, the result in ST(destination)
+   void arithmetic(int ext, int destination, Real b, FloatEnvironment& environment);
+   void compare(Real a, Real b, FloatEnvironment& environment);
+   void storeInteger(int size, int address, bool thenPop, FloatEnvironment& environment); // FIST, FISTP
+   void loadBcd(int address, FloatEnvironment& environment);
+   void storeBcd(int address, FloatEnvironment& environment);
+   void storeEnvironment(int address);
+   void loadEnvironment(int address);
+   void examine(); // FXAM
+   void transcendental(byte ModRegRM, FloatEnvironment& environment); // D9 F0-FF
+
+   Real registers[8];
+   byte tags[8];
+   int top;
+   word controlWord;
+   word statusWord; // without TOP
+   int instructionPointer = 0, operandPointer = 0; // of the last instruction that was not a control instruction
+   word lastOpcode = 0;
+   Memory* memory;
+};
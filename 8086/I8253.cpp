@@ -0,0 +1,103 @@
+#include "I8253.h"
+
+I8253::I8253(I8259& pic, Scheduler& scheduler)
+   : pic(pic), scheduler(scheduler), clock(scheduler.clock), edgeEvent(scheduler.add([this] { rise(); })) {}
+
+void I8253::rise() {
+   pic.request(0);
+   const Counter& counter = counters[0];
+   if (counter.mode == 2 || counter.mode == 3) { // rate generator, square wave: periodic, edges missed collapse into one
+      const unsigned long long period = (unsigned long long)counter.initial * CLOCKS_PER_COUNT;
+      edge += ((clock - edge) / period + 1) * period;
+      scheduler.schedule(edgeEvent, edge);
+   } // the other modes raise their output once, at terminal count
+}
+
+word I8253::count(const Counter& counter) const {
+   if (!counter.counting)
+      return (word)counter.initial;
+   const unsigned long long elapsed = (clock - counter.start) / CLOCKS_PER_COUNT;
+   switch (counter.mode) {
+   case 2: // initial down to 1, then reloaded
+      return (word)(counter.initial - elapsed % counter.initial);
+   case 3: // down by two, twice per period
+      return (word)(counter.initial - elapsed * 2 % counter.initial);
+   default: // down past 0, wrapping
+      return (word)(counter.initial - elapsed);
+   }
+}
+
+void I8253::load(int number, unsigned int initial) {
+   Counter& counter = counters[number];
+   counter.initial = initial ? initial : 0x1'0000;
+   counter.start = clock;
+   counter.counting = true;
+   if (number == 0) {
+      edge = clock + (unsigned long long)counter.initial * CLOCKS_PER_COUNT;
+      scheduler.schedule(edgeEvent, edge);
+   }
+}
+
+byte I8253::in(word port) {
+   if ((port & 3) == 3) // the control word register cannot be read
+      return 0xFF;
+   Counter& counter = counters[port & 3];
+   const word value = counter.latched ? counter.latch : count(counter);
+   switch (counter.access) {
+   case 1:
+      counter.latched = false;
+      return (byte)value;
+   case 2:
+      counter.latched = false;
+      return (byte)(value >> 8);
+   default:
+      counter.readMSB = !counter.readMSB;
+      if (counter.readMSB)
+         return (byte)value;
+      counter.latched = false;
+      return (byte)(value >> 8);
+   }
+}
+
+void I8253::out(word port, byte value) {
+   if ((port & 3) == 3) { // control word: SC1 SC0 RL1 RL0 M2 M1 M0 BCD
+      const int number = value >> 6;
+      if (number == 3) // read-back, 8254 only
+         return;
+      Counter& counter = counters[number];
+      const int access = value >> 4 & 3;
+      if (access == 0) { // counter latch command
+         if (!counter.latched) {
+            counter.latched = true;
+            counter.latch = count(counter);
+         }
+         return;
+      }
+      counter.access = (byte)access;
+      counter.mode = value >> 1 & 7;
+      if (counter.mode > 5) // 6 and 7 are 2 and 3
+         counter.mode -= 4;
+      counter.counting = counter.latched = counter.writeMSB = counter.readMSB = false;
+      if (number == 0)
+         scheduler.cancel(edgeEvent);
+      return;
+   }
+
+   const int number = port & 3;
+   Counter& counter = counters[number];
+   switch (counter.access) {
+   case 1:
+      load(number, value);
+      break;
+   case 2:
+      load(number, value << 8);
+      break;
+   default:
+      counter.writeMSB = !counter.writeMSB;
+      if (counter.writeMSB)
+         counter.low = value;
+      else
+         load(number, counter.low | value << 8);
+      break;
+   }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Common.h"
+#include "I8259.h"
+#include "IO.h"
+#include "Scheduler.h"
+
+// 8253 Programmable Interval Timer at ports 40h-43h. Its counters run at 1.193182 MHz, one count every
+// 4 clocks of the 4.77 MHz processor, so their state is worked out from the processor's clock when it
+// is needed instead of being counted down. Counter 0 drives IR0 of the interrupt controller (the timer
+// tick, 18.2 a second with the BIOS count of 65536); counters 1 and 2 count but drive nothing.
+class I8253 : public IODevice {
+public:
+   static constexpr int CLOCKS_PER_COUNT = 4;
+
+   // Counter 0's rising edges are events of scheduler, which keeps the processor's clock
+   I8253(I8259& pic, Scheduler& scheduler);
+
+   byte in(word port) override;
+   void out(word port, byte value) override;
+private:
+   struct Counter {
+      byte mode = 0;             // 0-5
+      byte access = 3;           // RL: 1 LSB only, 2 MSB only, 3 LSB then MSB
+      unsigned int initial = 0x1'0000; // count written, 0 meaning 65536
+      unsigned long long start = 0; // clock the count was loaded at
+      bool counting = false;
+      byte low = 0;              // LSB written, waiting for the MSB
+      bool writeMSB = false, readMSB = false; // which byte the next write and read are for
+      bool latched = false;      // counter latch command: reads return latch until it is read
+      word latch = 0;
+   } counters[3];
+
+   word count(const Counter& counter) const; // the counting element now
+   void load(int number, unsigned int initial);
+   void rise(); // counter 0's output has risen: request IR0, and schedule the next edge
+
+   unsigned long long edge = 0; // clock of counter 0's next rising edge, when scheduled
+   I8259& pic;
+   Scheduler& scheduler;
+   const unsigned long long& clock;
+   int edgeEvent;
+};
@@ -0,0 +1,81 @@
+#include "I8259.h"
+
+namespace {
+   // Number of the highest priority (lowest numbered) bit set, 8 if none
+   int highest(byte bits) {
+      for (int n = 0; n < 8; n++)
+         if (bits & 1 << n)
+            return n;
+      return 8;
+   }
+}
+
+I8259::I8259(bool& INTR, Scheduler& scheduler, int wake) : INTR(INTR), scheduler(scheduler), wake(wake) {}
+
+void I8259::request(int irq) {
+   irr |= 1 << irq;
+   update();
+}
+
+byte I8259::acknowledge() {
+   const int irq = highest(irr & ~imr);
+   if (irq == 8) // the request went away before INTA: the 8259A answers with IR7
+      return vectorBase | 7;
+   irr &= ~(1 << irq);
+   if (!autoEOI)
+      isr |= 1 << irq;
+   update();
+   return vectorBase | irq;
+}
+
+// A request is passed on if it is not masked and has a higher priority than any in service
+void I8259::update() {
+   INTR = highest(irr & ~imr) < highest(isr);
+   if (INTR)
+      scheduler.schedule(wake, scheduler.clock);
+}
+
+byte I8259::in(word port) {
+   if (port & 1)
+      return imr;
+   return readISR ? isr : irr;
+}
+
+void I8259::out(word port, byte value) {
+   if (port & 1) {
+      switch (nextICW) {
+      case 2: // ICW2: vector base
+         vectorBase = value & 0xF8;
+         nextICW = !(icw1 & 0x02) ? 3 : (icw1 & 0x01) ? 4 : 0;
+         break;
+      case 3: // ICW3: cascading, which the PC does not use
+         nextICW = (icw1 & 0x01) ? 4 : 0;
+         break;
+      case 4: // ICW4: 8086 mode, automatic EOI
+         autoEOI = value & 0x02;
+         nextICW = 0;
+         break;
+      default: // OCW1: mask
+         imr = value;
+         break;
+      }
+   } else if (value & 0x10) { // ICW1: start of initialisation
+      icw1 = value;
+      irr = isr = imr = 0;
+      autoEOI = readISR = false;
+      nextICW = 2;
+   } else if (value & 0x08) { // OCW3: register to read
+      if (value & 0x02)
+         readISR = value & 0x01;
+   } else { // OCW2: end of interrupt, bits 7-5 = R SL EOI
+      switch (value >> 5) {
+      case 1: case 5: // non-specific EOI (rotation not modelled): the highest priority in service ends
+         isr &= isr - 1;
+         break;
+      case 3: case 7: // specific EOI of IR(bits 2-0)
+         isr &= ~(1 << (value & 7));
+         break;
+      }
+   }
+   update();
+}
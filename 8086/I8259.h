@@ -0,0 +1,36 @@
+#pragma once
+#include "Common.h"
+#include "IO.h"
+#include "Scheduler.h"
+
+// 8259A Programmable Interrupt Controller, the single controller of the PC at ports 20h-21h.
+// Edge triggered with fully nested priority, IR0 highest. Cascading, priority rotation, special mask mode
+// and polling are not modelled. Until it is initialised (ICW1) every request is masked.
+class I8259 : public IODevice {
+public:
+   // INTR is the processor's interrupt request line. wake is the processor's event that takes
+   // interrupts; it is scheduled for now when INTR goes active
+   I8259(bool& INTR, Scheduler& scheduler, int wake);
+
+   void request(int irq); // a rising edge on IRn
+   // Interrupt acknowledge: the vector of the highest priority request, which goes in service
+   byte acknowledge();
+
+   byte in(word port) override;
+   void out(word port, byte value) override;
+private:
+   void update(); // drive INTR from the requests, mask and in-service registers
+
+   byte irr = 0;    // interrupt request register
+   byte isr = 0;    // in-service register
+   byte imr = 0xFF; // interrupt mask register
+   byte vectorBase = 0; // ICW2: T7-T3 of the vectors
+   byte icw1 = 0;
+   int nextICW = 0;     // initialisation command word the next write to port 21h is, 0 when initialised
+   bool autoEOI = false; // ICW4 AEOI: in-service bits are not set, so no EOI is needed
+   bool readISR = false; // OCW3: port 20h reads the ISR instead of the IRR
+
+   bool& INTR;
+   Scheduler& scheduler;
+   int wake;
+};
@@ -1,5 +1,15 @@
 #include "IO.h"
 
 
-IO::IO() {}
+IO::IO() : split(*this), bytePorts(0x1'0000, &unattached), wordPorts(0x1'0000, &unattached) {}
 IO::~IO() {}
+
+void IO::attach(word first, word last, IODevice* device) {
+   for (int port = first; port <= last; port++)
+      bytePorts[port] = device;
+   // The words that start or end in the range, including the one overlapping each end
+   for (int port = first - 1; port <= last; port++) {
+      const word at = (word)port;
+      wordPorts[at] = bytePorts[at] == bytePorts[(word)(at + 1)] ? bytePorts[at] : &split;
+   }
+}
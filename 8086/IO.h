@@ -1,12 +1,63 @@
 #pragma once
 #include "Common.h"
+#include <vector>
 
+// A device that answers IN and OUT on the ports attached to it with IO::attach()
+class IODevice {
+public:
+   virtual ~IODevice() {}
+   virtual byte in(word port) = 0;
+   virtual void out(word port, byte value) = 0;
+   // A word at port and port + 1, both attached to this device: the byte at port, then the byte at port + 1
+   // unless the device handles the word as one
+   virtual word inWord(word port) { return (word)(in(port) | in((word)(port + 1)) << 8); }
+   virtual void outWord(word port, word value) {
+      out(port, (byte)value);
+      out((word)(port + 1), (byte)(value >> 8));
+   }
+};
+
+// The 8086's 64K port space. Each port has an entry for byte and one for word transfers holding the device
+// to call, so IN and OUT are one indexed virtual call; ports no device is attached to share a default.
 class IO {
 public:
    IO();
    ~IO();
 
-   template<typename T> T read(word port) { return 0; }
-   template<typename T> void write(word port, T value) {}
-};
+   // Route ports first through last to device, replacing what was attached to them; the caller keeps ownership
+   void attach(word first, word last, IODevice* device);
+
+   template<typename T> T read(word port) {
+      if constexpr (sizeof(T) == 1)
+         return bytePorts[port]->in(port);
+      else
+         return (T)wordPorts[port]->inWord(port);
+   }
+   template<typename T> void write(word port, T value) {
+      if constexpr (sizeof(T) == 1)
+         bytePorts[port]->out(port, (byte)value);
+      else
+         wordPorts[port]->outWord(port, (word)value);
+   }
+private:
+   // Ports no device is attached to: IN reads 0 and OUT is ignored
+   class Unattached : public IODevice {
+   public:
+      byte in(word) override { return 0; }
+      void out(word, byte) override {}
+   };
+   // A word whose bytes are on different devices: each byte goes to its own port's device
+   class Split : public IODevice {
+   public:
+      explicit Split(const IO& io) : io(io) {}
+      byte in(word port) override { return io.bytePorts[port]->in(port); }
+      void out(word port, byte value) override { io.bytePorts[port]->out(port, value); }
+   private:
+      const IO& io;
+   };
 
+   Unattached unattached;
+   Split split;
+   std::vector<IODevice*> bytePorts; // 64K entries
+   std::vector<IODevice*> wordPorts; // the device of both port and port + 1, otherwise &split
+};
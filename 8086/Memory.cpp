@@ -1,13 +1,131 @@
 #include "Memory.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
+#include <vector>
 
-Memory::Memory(std::string file) {
-   memory = new byte[0x10'0000]; // Megabyte of memory
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MEMORY_SSE2
+#endif
+
+namespace {
+   enum : byte { RAW, RUNS }; // page encodings of a dump
+#pragma pack(push, 1)
+   struct DumpHeader {
+      char magic[4];
+      word pageBits; // page size the dump was made with
+      word pages;    // entries in the index
+   };
+   struct DumpEntry {
+      word page;         // page number: address >> PAGE_BITS
+      byte encoding;     // RAW or RUNS
+      byte reserved;
+      uint32_t offset;   // of its contents, from the end of the index
+      uint32_t size;     // bytes of contents
+   };
+#pragma pack(pop)
+
+   // All of length bytes (a multiple of 128) are zero. The bytes are ORed together a cache line or two at a
+   // time, so a page that is not zero is usually found in its first 128 bytes
+   bool isZero(const byte* bytes, int length) {
+      for (int i = 0; i < length; i += 128) {
+#if defined(__AVX2__)
+         const __m256i* v = (const __m256i*)&bytes[i];
+         const __m256i x = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256(v), _mm256_loadu_si256(v + 1)),
+                                           _mm256_or_si256(_mm256_loadu_si256(v + 2), _mm256_loadu_si256(v + 3)));
+         if (!_mm256_testz_si256(x, x))
+            return false;
+#elif defined(MEMORY_SSE2)
+         const __m128i* v = (const __m128i*)&bytes[i];
+         __m128i x = _mm_loadu_si128(v);
+         for (int j = 1; j < 8; j++)
+            x = _mm_or_si128(x, _mm_loadu_si128(v + j));
+         if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xFFFF)
+            return false;
+#else
+         uint64_t x = 0;
+         for (int j = 0; j < 128; j += 8) {
+            uint64_t part;
+            memcpy(&part, &bytes[i + j], sizeof part);
+            x |= part;
+         }
+         if (x)
+            return false;
+#endif
+      }
+      return true;
+   }
+
+   // Run-length encoding of a page: a control byte n < 128 is followed by n + 1 bytes as they are, and
+   // n >= 128 by one byte repeated n - 125 times (3 to 130)
+   void encode(const byte* bytes, std::vector<byte>& out) {
+      constexpr int LENGTH = 1 << Memory::PAGE_BITS;
+      int literal = 0; // start of the bytes not yet written
+      int i = 0;
+      auto flush = [&](int end) {
+         while (literal < end) {
+            const int count = std::min(end - literal, 128);
+            out.push_back((byte)(count - 1));
+            out.insert(out.end(), &bytes[literal], &bytes[literal + count]);
+            literal += count;
+         }
+      };
+      while (i < LENGTH) {
+         int run = 1;
+         while (i + run < LENGTH && run < 130 && bytes[i + run] == bytes[i])
+            run++;
+         if (run >= 3) {
+            flush(i);
+            out.push_back((byte)(run + 125));
+            out.push_back(bytes[i]);
+            literal = i += run;
+         } else {
+            i += run;
+         }
+      }
+      flush(LENGTH);
+   }
+
+   // False if the runs do not make exactly one page
+   bool decode(const byte* in, size_t size, byte* page) {
+      constexpr int LENGTH = 1 << Memory::PAGE_BITS;
+      int at = 0;
+      for (size_t i = 0; i < size; ) {
+         const byte control = in[i++];
+         if (control < 128) {
+            const int count = control + 1;
+            if (at + count > LENGTH || i + count > size)
+               return false;
+            memcpy(&page[at], &in[i], count);
+            i += count;
+            at += count;
+         } else {
+            const int count = control - 125;
+            if (at + count > LENGTH || i >= size)
+               return false;
+            memset(&page[at], in[i++], count);
+            at += count;
+         }
+      }
+      return at == LENGTH;
+   }
+}
+
+Memory::Memory() {
+   memory = new byte[0x10'0000 + MIRROR](); // Megabyte of memory, and the mirror of its first 64K
+   map(0, 0x10'0000, PageType::RAM);
+}
+
+Memory::Memory(std::string file) : Memory() {
    std::ifstream stream(file, std::ios::binary);
    stream.read((char*)memory, 0xf'ffff);
    stream.close();
+   map(0, MIRROR, PageType::RAM); // copies the image's first 64K to the mirror
 
    int i = 0;
    for (int j = 0; j < 8; j++) {
@@ -20,16 +138,146 @@ Memory::Memory(std::string file) {
 }
 
 Memory::~Memory() {
-   delete memory;
+   delete[] memory;
+}
+
+void Memory::map(int address, int length, PageType type, MemoryDevice* device) {
+   for (int page = address >> PAGE_BITS; page < PAGES && page <= (address + length - 1) >> PAGE_BITS; page++) {
+      const byte flags = type == PageType::MMIO ? DEVICE_READ | DEVICE_WRITE
+                       : type == PageType::ROM || type == PageType::WATCHED ? DEVICE_WRITE
+                       : 0;
+      pages[page] = { 0, flags, type, device };
+      if (page < (MIRROR >> PAGE_BITS)) { // the first 64K, and its mirror
+         const int mirrored = page + PAGES;
+         pages[mirrored] = { -0x10'0000, flags, type, device };
+         pages[page].mirror = 0x10'0000;
+         memcpy(&memory[mirrored << PAGE_BITS], &memory[page << PAGE_BITS], 1 << PAGE_BITS);
+      }
+      changed(page);
+   }
+}
+
+byte Memory::readByte(int address) const {
+   address &= 0xF'FFFF;
+   const Page& page = pages[address >> PAGE_BITS];
+   if (page.type == PageType::MMIO)
+      return page.device->read(address);
+   return memory[address];
+}
+
+void Memory::writeBytes(int address, const byte* bytes, int length) {
+   for (int i = 0; i < length; i++) {
+      const int physical = (address + i) & 0xF'FFFF;
+      const Page& page = pages[physical >> PAGE_BITS];
+      switch (page.type) {
+      case PageType::RAM:
+         memory[physical] = bytes[i];
+         memory[physical + page.mirror] = bytes[i];
+         changed(physical >> PAGE_BITS);
+         break;
+      case PageType::ROM:
+         break;
+      case PageType::WATCHED:
+         if (memory[physical] == bytes[i]) // the device sees only changes
+            break;
+         memory[physical] = bytes[i];
+         memory[physical + page.mirror] = bytes[i];
+         changed(physical >> PAGE_BITS);
+         page.device->written(physical, 1);
+         break;
+      case PageType::MMIO:
+         page.device->write(physical, bytes[i]);
+         break;
+      }
+   }
 }
 
-void Memory::memDump(const char* file) {
+bool Memory::direct(int address, int length, bool write) const {
+   if (length <= 0)
+      return true;
+   if (address < 0 || address + length > 0x10'0000)
+      return false;
+   for (int page = address >> PAGE_BITS; page <= (address + length - 1) >> PAGE_BITS; page++)
+      if (pages[page].type == PageType::MMIO || (write && pages[page].type == PageType::ROM))
+         return false;
+   return true;
+}
+
+// Dump file: header, index of the pages saved, then their contents in index order (all little endian)
+void Memory::memDump(const char* file, bool compress) const {
+   std::vector<byte> index, contents;
+   int saved = 0;
+   for (int page = 0; page < PAGES; page++) {
+      const byte* bytes = &memory[page << PAGE_BITS];
+      if (isZero(bytes, 1 << PAGE_BITS))
+         continue;
+      const size_t offset = contents.size();
+      byte encoding = RAW;
+      if (compress) {
+         encode(bytes, contents);
+         if (contents.size() - offset < (1 << PAGE_BITS))
+            encoding = RUNS;
+         else
+            contents.resize(offset); // no smaller: saved as it is
+      }
+      if (encoding == RAW)
+         contents.insert(contents.end(), bytes, bytes + (1 << PAGE_BITS));
+      const DumpEntry entry = { (word)page, encoding, 0, (uint32_t)offset, (uint32_t)(contents.size() - offset) };
+      index.insert(index.end(), (const byte*)&entry, (const byte*)&entry + sizeof entry);
+      saved++;
+   }
+   const DumpHeader header = { { 'M', 'E', 'M', '1' }, (word)PAGE_BITS, (word)saved };
+
    std::ofstream stream(file, std::ios::binary);
+   stream.write((const char*)&header, sizeof header);
+   stream.write((const char*)index.data(), index.size());
+   stream.write((const char*)contents.data(), contents.size());
+}
 
-   int length = 0xf'ffff;
-   while (memory[length] == 0 && length >= 0)
-      length--;
+bool Memory::memLoad(const char* file) {
+   std::ifstream stream(file, std::ios::binary);
+   DumpHeader header;
+   if (!stream.read((char*)&header, sizeof header) || memcmp(header.magic, "MEM1", 4) != 0
+      || header.pageBits != PAGE_BITS || header.pages > PAGES)
+      return false;
+   std::vector<DumpEntry> index(header.pages);
+   std::vector<byte> contents;
+   if (!stream.read((char*)index.data(), index.size() * sizeof(DumpEntry)))
+      return false;
+   contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+   for (const DumpEntry& entry : index)
+      if (entry.page >= PAGES || entry.encoding > RUNS || (uint64_t)entry.offset + entry.size > contents.size()
+         || (entry.encoding == RAW && entry.size != (1 << PAGE_BITS)))
+         return false;
 
-   stream.write((char*)memory, length);
-   stream.close();
-}
\ No newline at end of file
+   // Every page is decoded before memory is touched, so a file that is not a dump leaves it as it was
+   std::vector<byte> pages(index.size() << PAGE_BITS);
+   for (size_t i = 0; i < index.size(); i++) {
+      const byte* bytes = contents.data() + index[i].offset;
+      byte* page = &pages[i << PAGE_BITS];
+      if (index[i].encoding == RAW)
+         memcpy(page, bytes, 1 << PAGE_BITS);
+      else if (!decode(bytes, index[i].size, page))
+         return false;
+   }
+   memset(memory, 0, 0x10'0000);
+   for (size_t i = 0; i < index.size(); i++)
+      memcpy(&memory[index[i].page << PAGE_BITS], &pages[i << PAGE_BITS], 1 << PAGE_BITS);
+   written(0, 0x10'0000); // every page changed, the mirror of the first 64K, and to the devices of their pages
+   return true;
+}
+
+void Memory::written(int address, int length) {
+   if (length <= 0)
+      return;
+   for (int page = address >> PAGE_BITS; page <= (address + length - 1) >> PAGE_BITS; page++) {
+      changed(page & (PAGES - 1));
+      if (MemoryDevice* device = pages[page & (PAGES - 1)].device) {
+         const int first = std::max(address, page << PAGE_BITS);
+         const int end = std::min(address + length, (page + 1) << PAGE_BITS);
+         device->written(first & 0xF'FFFF, end - first);
+      }
+   }
+   if (address < MIRROR) // keep the mirror of the first 64K the same
+      memcpy(&memory[0x10'0000 + address], &memory[address], std::min(length, MIRROR - address));
+}
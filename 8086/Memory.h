@@ -1,17 +1,113 @@
 #pragma once
 #include "Common.h"
+#include <cstring>
 #include <string>
 
+// A device that answers reads and writes to the pages mapped to it with Memory::map() (MMIO), or that is
+// told of the changes to its pages (WATCHED)
+class MemoryDevice {
+public:
+   virtual ~MemoryDevice() {}
+   virtual byte read(int) { return 0xFF; } // MMIO: address is physical, within the megabyte
+   virtual void write(int, byte) {}
+   // Bytes [address, address + length) of its pages changed in memory: a WATCHED byte written with a new
+   // value, or a range reported with Memory::written()
+   virtual void written(int, int) {}
+};
+
 class Memory {
 public:
-   Memory(std::string file);
+   Memory(); // all RAM, zeroed
+   Memory(std::string file); // and the first megabyte of file copied into it
    ~Memory();
 
-   void memDump(const char* file);
+   // Save the megabyte to file as its non-zero 4K pages, each run-length encoded if that makes it smaller,
+   // behind an index of the pages saved. memLoad() reads it back, with every page not in the file zeroed;
+   // false if the file is not a dump. What devices hold of MMIO pages is not saved, only what is in memory
+   void memDump(const char* file, bool compress = true) const;
+   bool memLoad(const char* file);
+
+   // The megabyte is mapped in 4K pages. Writes are counted per page so decoded instructions can tell
+   // when their code has changed
+   static constexpr int PAGE_BITS = 12;
+   static constexpr int PAGES = 0x10'0000 >> PAGE_BITS;
 
-   template<typename T> T& mem(int address) {
-      return *(T*)(&memory[address]);
+   // Segment:offset reaches 64K past the megabyte (FFFF:FFFF is 0x10FFEF). The 8086 wraps those addresses
+   // to the bottom of memory, so the first 64K is kept a second time above the megabyte; any address a
+   // segment and offset can form, and a word at 0xFFFFF, is then read with no wrap check
+   static constexpr int MIRROR = 0x1'0000;
+   static constexpr int MAPPED_PAGES = (0x10'0000 + MIRROR) >> PAGE_BITS;
+
+   enum class PageType : byte {
+      RAM, // read and written in place
+      ROM, // read in place, writes are ignored
+      WATCHED, // read and written in place, with the bytes a write changes passed to the page's MemoryDevice
+      MMIO // reads and writes go to the page's MemoryDevice
+   };
+   // Give the pages covering [address, address + length) a type, and for MMIO and WATCHED the device of them
+   void map(int address, int length, PageType type, MemoryDevice* device = nullptr);
+
+   template<typename T> T read(int address) const {
+      const int last = address + (int)sizeof(T) - 1;
+      if ((pages[address >> PAGE_BITS].flags | pages[last >> PAGE_BITS].flags) & DEVICE_READ)
+         return readDevice<T>(address);
+      T value;
+      memcpy(&value, &memory[address], sizeof(T));
+      return value;
    }
+   template<typename T> void write(int address, T value) {
+      const int last = address + (int)sizeof(T) - 1;
+      const Page& page = pages[address >> PAGE_BITS];
+      if ((page.flags & DEVICE_WRITE) || (last >> PAGE_BITS) != (address >> PAGE_BITS)) { // or straddles two pages
+         writeBytes(address, (const byte*)&value, sizeof(T));
+         return;
+      }
+      // Pages in the first 64K and its mirror store twice, to keep both copies the same; the others
+      // store to the same place twice rather than branch
+      memcpy(&memory[address], &value, sizeof(T));
+      memcpy(&memory[address + page.mirror], &value, sizeof(T));
+      changed((address >> PAGE_BITS) & (PAGES - 1));
+   }
+
+   // Number of writes to the page holding address (wraps; only equality is meaningful)
+   unsigned int pageGeneration(int address) const { return generation[(address >> PAGE_BITS) & (PAGES - 1)]; }
+
+   // Direct access for block operations. Only ranges direct() accepts may be used, and changes
+   // must be reported through written()
+   byte* data() { return memory; }
+   bool direct(int address, int length, bool write) const; // no MMIO, and no ROM if written, within the megabyte
+   void written(int address, int length); // and to the devices of WATCHED and MMIO pages in the range
+
+   // Pages written or mapped since clearDirty() (all of them before the first), for incremental checkpoints
+   bool dirty(int page) const { return dirtyPages[page >> 6] >> (page & 63) & 1; }
+   void clearDirty() { memset(dirtyPages, 0, sizeof dirtyPages); }
 private:
+   enum : byte { DEVICE_READ = 1, DEVICE_WRITE = 2 }; // page flags: not plain memory for reads/writes
+
+   struct Page {
+      int mirror;           // distance to the other copy of a page in the first 64K or its mirror, otherwise 0
+      byte flags;           // DEVICE_READ, DEVICE_WRITE
+      PageType type;
+      MemoryDevice* device; // MMIO and WATCHED only
+   };
+
+   template<typename T> T readDevice(int address) const {
+      byte bytes[sizeof(T)];
+      for (int i = 0; i < (int)sizeof(T); i++)
+         bytes[i] = readByte(address + i);
+      T value;
+      memcpy(&value, bytes, sizeof(T));
+      return value;
+   }
+   void changed(int page) {
+      generation[page]++;
+      dirtyPages[page >> 6] |= 1ull << (page & 63);
+   }
+   byte readByte(int address) const;
+   void writeBytes(int address, const byte* bytes, int length);
+
    byte *memory;
+   Page pages[MAPPED_PAGES];
+   unsigned int generation[PAGES] = {};
+   uint64_t dirtyPages[PAGES / 64] = {}; // bit per page, set with generation
 };
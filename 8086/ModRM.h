@@ -0,0 +1,62 @@
+#pragma once
+#include "Common.h"
+
+// Everything the ModR/M byte implies, worked out once for all 256 values
+// (IA V2 2-4 Table 2-1) (8086 Family 4-20 Table 4-10)
+struct ModRM {
+   // Register numbers of the 16-bit address registers (8086 Family Table 4-9).
+   // NO_REGISTER is an extra register that always reads 0, so every address is base + index + disp.
+   enum : byte { BX = 3, BP = 5, SI = 6, DI = 7, NO_REGISTER = 8 };
+
+   byte mode, reg, rm; // fields of the byte; reg is the /ext of group opcodes
+   byte dispSize;      // bytes of displacement that follow: 0, 1 (disp8, sign extended) or 2 (disp16)
+   byte base, index;   // address registers added to the displacement
+   byte segment;       // default segment register number (ES CS SS DS): SS if BP is the base, DS otherwise
+   bool isRegister;    // mod=11: r/m names a register, there is no effective address
+   byte eaClocks;      // effective address calculation time, 0 for a register (8086 Family Table 2-20)
+};
+
+struct ModRMTable {
+   ModRM entries[256];
+
+   constexpr ModRMTable() : entries{} {
+      constexpr byte DS = 3, SS = 2;
+      // base and index of mod=00-10 by r/m
+      constexpr byte bases[8]   = { ModRM::BX, ModRM::BX, ModRM::BP, ModRM::BP, ModRM::NO_REGISTER, ModRM::NO_REGISTER, ModRM::BP, ModRM::BX };
+      constexpr byte indexes[8] = { ModRM::SI, ModRM::DI, ModRM::SI, ModRM::DI, ModRM::SI, ModRM::DI, ModRM::NO_REGISTER, ModRM::NO_REGISTER };
+
+      for (int i = 0; i < 256; i++) {
+         ModRM& e = entries[i];
+         e.mode = i >> 6;
+         e.reg = (i >> 3) & 0b111;
+         e.rm = i & 0b111;
+         e.isRegister = e.mode == 3;
+         e.base = bases[e.rm];
+         e.index = indexes[e.rm];
+         e.dispSize = e.mode == 1 ? 1 : e.mode == 2 ? 2 : 0;
+         if (e.mode == 0 && e.rm == 6) { // direct address: disp16 alone, not [BP]
+            e.dispSize = 2;
+            e.base = ModRM::NO_REGISTER;
+         }
+         if (e.isRegister) {
+            e.dispSize = 0;
+            e.base = e.index = ModRM::NO_REGISTER;
+         }
+         e.segment = e.base == ModRM::BP ? SS : DS;
+
+         // Displacement only 6; base or index 5, with a displacement 9; base + index 7 (BP+DI, BX+SI)
+         // or 8 (BP+SI, BX+DI), with a displacement 11 or 12
+         if (e.isRegister)
+            e.eaClocks = 0;
+         else if (e.base == ModRM::NO_REGISTER && e.index == ModRM::NO_REGISTER)
+            e.eaClocks = 6;
+         else if (e.base == ModRM::NO_REGISTER || e.index == ModRM::NO_REGISTER)
+            e.eaClocks = e.dispSize ? 9 : 5;
+         else
+            e.eaClocks = (e.rm == 1 || e.rm == 2 ? 8 : 7) + (e.dispSize ? 4 : 0);
+      }
+   }
+
+   constexpr const ModRM& operator[](byte modrm) const { return entries[modrm]; }
+};
+inline constexpr ModRMTable modrmTable;
@@ -0,0 +1,85 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler(const unsigned long long& clock) : clock(clock) {}
+
+int Scheduler::add(Callback callback) {
+   callbacks.push_back(std::move(callback));
+   position.push_back(-1);
+   return (int)callbacks.size() - 1;
+}
+
+void Scheduler::schedule(int event, unsigned long long deadline) {
+   int index = position[event];
+   if (index < 0) {
+      index = (int)heap.size();
+      heap.push_back({ deadline, event });
+      position[event] = index;
+      up(index);
+   } else {
+      const unsigned long long previous = heap[index].deadline;
+      heap[index].deadline = deadline;
+      if (deadline < previous) up(index);
+      else                     down(index);
+   }
+   next = heap[0].deadline;
+}
+
+void Scheduler::cancel(int event) {
+   if (position[event] >= 0)
+      remove(position[event]);
+   next = heap.empty() ? NEVER : heap[0].deadline;
+}
+
+void Scheduler::dispatch() {
+   while (!heap.empty() && heap[0].deadline <= clock) {
+      const int event = heap[0].event;
+      remove(0);
+      callbacks[event]();
+   }
+   next = heap.empty() ? NEVER : heap[0].deadline;
+}
+
+void Scheduler::place(int index, Entry entry) {
+   heap[index] = entry;
+   position[entry.event] = index;
+}
+
+void Scheduler::up(int index) {
+   const Entry entry = heap[index];
+   while (index > 0) {
+      const int parent = (index - 1) / 2;
+      if (heap[parent].deadline <= entry.deadline)
+         break;
+      place(index, heap[parent]);
+      index = parent;
+   }
+   place(index, entry);
+}
+
+void Scheduler::down(int index) {
+   const Entry entry = heap[index];
+   const int size = (int)heap.size();
+   for (;;) {
+      int child = 2 * index + 1;
+      if (child >= size)
+         break;
+      if (child + 1 < size && heap[child + 1].deadline < heap[child].deadline)
+         child++;
+      if (entry.deadline <= heap[child].deadline)
+         break;
+      place(index, heap[child]);
+      index = child;
+   }
+   place(index, entry);
+}
+
+void Scheduler::remove(int index) {
+   position[heap[index].event] = -1;
+   const Entry last = heap.back();
+   heap.pop_back();
+   if (index == (int)heap.size())
+      return;
+   place(index, last);
+   up(index);
+   down(position[last.event]);
+}
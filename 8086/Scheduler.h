@@ -0,0 +1,44 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+// Events due at clock cycles, shared by the processor and its devices. Devices schedule their next
+// event instead of being polled: the processor runs straight-line until the earliest deadline, `next`,
+// and then calls dispatch().
+// The events are kept in a binary heap ordered by deadline, with each event's position in it, so an
+// event can be rescheduled or cancelled in place.
+class Scheduler {
+public:
+   static constexpr unsigned long long NEVER = ~0ull;
+   typedef std::function<void()> Callback;
+
+   // clock is the processor's clock count
+   explicit Scheduler(const unsigned long long& clock);
+
+   // A new event, not yet scheduled; returns its number for schedule() and cancel()
+   int add(Callback callback);
+   // Have event run when the clock reaches deadline, replacing any deadline it had
+   void schedule(int event, unsigned long long deadline);
+   void cancel(int event);
+   bool scheduled(int event) const { return position[event] >= 0; }
+
+   // Run the events due by now, earliest first. Events may schedule themselves or others again;
+   // those due by now also run before dispatch() returns
+   void dispatch();
+
+   unsigned long long next = NEVER; // earliest deadline
+   const unsigned long long& clock;
+private:
+   struct Entry {
+      unsigned long long deadline;
+      int event;
+   };
+   void place(int index, Entry entry); // put entry at heap index, keeping position up to date
+   void up(int index);
+   void down(int index);
+   void remove(int index);
+
+   std::vector<Entry> heap;        // heap[0] is the earliest
+   std::vector<int> position;      // heap index of each event, -1 if not scheduled
+   std::vector<Callback> callbacks;
+};
@@ -2,12 +2,243 @@
 #include "Memory.h"
 #include "I8086.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <bitset>
+#include <string>
+#include <type_traits>
 
 
-int main() {
-   I8086 state(new Memory("Microsoft DOS 6.0 (3.5)/Full.img"), new IO);
-   state.run(77);
-}
\ No newline at end of file
+// Run headless with each trace policy and report throughput
+void Benchmark(const char* image, unsigned int instructions)
+{
+   const char* names[] = { "off:    ", "binary: ", "text:   " };
+   for (int policy = 0; policy < 3; policy++) {
+      I8086 state(new Memory(image), new IO);
+
+      unsigned int executed = 0;
+      auto start = std::chrono::steady_clock::now();
+      switch (policy) {
+      case 0: executed = state.run<I8086::Trace::Off>(instructions); break;
+      case 1: executed = state.run<I8086::Trace::Binary>(instructions); break;
+      case 2: executed = state.run<I8086::Trace::Text>(instructions); break;
+      }
+      std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+      std::cerr << names[policy] << executed << " instructions in " << seconds.count() << "s ("
+         << executed / seconds.count() << " instructions/s, " << state.clock() / seconds.count() / 1e6
+         << " guest MHz), decoded cache hit rate "
+         << 100.0 * state.decodeHits / (state.decodeHits + state.decodeMisses) << "%" << std::endl;
+   }
+}
+
+// Sum 1/k^2 for k up to 65535, outer times, on the 8087 kept in Real; each pass stores sqrt(6 * sum), near pi
+template<typename Real>
+void FpuBenchmark(const char* name, unsigned int outer)
+{
+   static const byte program[] = {
+      0xDB, 0xE3,             // 0500 FINIT
+      0xBA, 0x00, 0x00,       // 0502 MOV DX,outer
+      0xD9, 0xEE,             // 0505 FLDZ                sum
+      0xD9, 0xE8,             // 0507 FLD1                k
+      0xB9, 0xFF, 0xFF,       // 0509 MOV CX,FFFF
+      0xD9, 0xE8,             // 050C FLD1
+      0xD8, 0xF1,             // 050E FDIV ST,ST(1)       1/k
+      0xD8, 0xC8,             // 0510 FMUL ST,ST(0)       1/k^2
+      0xDE, 0xC2,             // 0512 FADDP ST(2),ST      sum += 1/k^2
+      0xD9, 0xE8,             // 0514 FLD1
+      0xDE, 0xC1,             // 0516 FADDP ST(1),ST      k += 1
+      0xE2, 0xF2,             // 0518 LOOP 050C
+      0xDD, 0xD8,             // 051A FSTP ST(0)
+      0xDE, 0x0E, 0x00, 0x06, // 051C FIMUL WORD [0600]   6
+      0xD9, 0xFA,             // 0520 FSQRT
+      0xDD, 0x1E, 0x08, 0x06, // 0522 FSTP QWORD [0608]
+      0x4A,                   // 0526 DEC DX
+      0x75, 0xDC,             // 0527 JNZ 0505
+      0xF4,                   // 0529 HLT
+   };
+   static const byte start[] = { 0xEA, 0x00, 0x05, 0x00, 0x00 }; // FFFF:0000 JMP 0000:0500
+
+   Memory* memory = new Memory();
+   for (int i = 0; i < (int)sizeof program; i++)
+      memory->write<byte>(0x500 + i, program[i]);
+   memory->write<word>(0x503, (word)outer);
+   for (int i = 0; i < (int)sizeof start; i++)
+      memory->write<byte>(0xF'FFF0 + i, start[i]);
+   memory->write<word>(0x600, 6);
+
+   I8087<Real> fpu(memory);
+   I8086 state(memory, new IO);
+   state.attach(&fpu);
+   unsigned long long executed = 0;
+   auto begin = std::chrono::steady_clock::now();
+   unsigned int slice;
+   do // until HLT
+      executed += slice = state.run(1'000'000);
+   while (slice == 1'000'000);
+   std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - begin;
+   double result;
+   const uint64_t bits = memory->read<uint64_t>(0x608);
+   memcpy(&result, &bits, sizeof result);
+
+   std::cerr.precision(17);
+   std::cerr << name << executed << " instructions in " << seconds.count() << "s (" << executed / seconds.count()
+      << " instructions/s), sqrt(6 * sum) = " << result << std::endl;
+}
+
+// ADD ADC SUB SBB AND OR XOR INC DEC on random operands of both widths, the ALU's result, individual status
+// flags, FLAGS word and all 16 conditions checked against values worked out here from signed and unsigned
+// arithmetic. Returns the number of mismatches
+template<typename T>
+int AluCheck(ALU& alu, int operation, T a, T b)
+{
+   static const char* names[] = { "ADD", "ADC", "SUB", "SBB", "AND", "OR", "XOR", "INC", "DEC" };
+   typedef std::make_signed_t<T> Signed;
+   const int bits = 8 * sizeof(T);
+   const int carryIn = alu.CF(), keptCarry = carryIn, keptA = alu.AF();
+   if (operation >= 7)
+      b = 1;
+   const int c = operation == 1 || operation == 3 ? carryIn : 0;
+
+   T result = 0;
+   switch (operation) {
+   case 0: result = alu.add<T>(a, b); break;
+   case 1: result = alu.adc<T>(a, b); break;
+   case 2: result = alu.sub<T>(a, b); break;
+   case 3: result = alu.sbb<T>(a, b); break;
+   case 4: result = alu._and<T>(a, b); break;
+   case 5: result = alu._or<T>(a, b); break;
+   case 6: result = alu._xor<T>(a, b); break;
+   case 7: result = alu.INC<T>(a); break;
+   case 8: result = alu.DEC<T>(a); break;
+   }
+
+   // Expected
+   long long value = 0, signedValue = 0;
+   int O = 0, C = 0, A = keptA;
+   switch (operation) {
+   case 0: case 1: case 7:
+      value = (long long)a + b + c;
+      signedValue = (long long)(Signed)a + (Signed)b + c;
+      C = operation == 7 ? keptCarry : value >> bits & 1;
+      A = (a & 0xF) + (b & 0xF) + c > 0xF;
+      break;
+   case 2: case 3: case 8:
+      value = (long long)a - b - c;
+      signedValue = (long long)(Signed)a - (Signed)b - c;
+      C = operation == 8 ? keptCarry : (long long)a < (long long)b + c;
+      A = (a & 0xF) < (b & 0xF) + c;
+      break;
+   case 4: value = signedValue = a & b; break;
+   case 5: value = signedValue = a | b; break;
+   case 6: value = signedValue = a ^ b; break;
+   }
+   if (operation < 4 || operation > 6)
+      O = signedValue < std::numeric_limits<Signed>::min() || signedValue > std::numeric_limits<Signed>::max();
+   const T expected = (T)value;
+   const int S = expected >> (bits - 1) & 1, Z = expected == 0, P = std::bitset<8>(expected & 0xFF).count() % 2 == 0;
+   const bool logic = operation >= 4 && operation <= 6; // A undefined
+
+   int mismatches = 0;
+   auto check = [&](const char* what, int got, int want) {
+      if (got == want)
+         return;
+      if (mismatches++ == 0)
+         std::cerr << names[operation] << (bits == 8 ? " byte " : " word ") << std::hex << (unsigned)a << ","
+            << (unsigned)b << " carry " << carryIn << ": ";
+      std::cerr << what << " " << got << " (expected " << want << ") ";
+   };
+   check("result", result, expected);
+   check("OF", alu.OF(), O);
+   check("SF", alu.SF(), S);
+   check("ZF", alu.ZF(), Z);
+   check("PF", alu.PF(), P);
+   check("CF", alu.CF(), C);
+   if (!logic)
+      check("AF", alu.AF(), A);
+   const bool conditions[16] = {
+      O == 1, O == 0, C == 1, C == 0, Z == 1, Z == 0, C || Z, !C && !Z,
+      S == 1, S == 0, P == 1, P == 0, S != O, S == O, Z || S != O, !Z && S == O
+   };
+   for (int test = 0; test < 16; test++) // from the pending record
+      check(("condition " + std::to_string(test)).c_str(), alu.condition(test), conditions[test]);
+   const word flags = alu.current().value, mask = logic ? 0x08C5 : 0x08D5;
+   for (int test = 0; test < 16; test++) // and from the FLAGS word
+      check(("materialized condition " + std::to_string(test)).c_str(), alu.condition(test), conditions[test]);
+   const word want = (word)(O << 0xB | S << 0x7 | Z << 0x6 | A << 0x4 | P << 0x2 | C);
+   check("FLAGS", flags & mask, want & mask);
+   if (mismatches)
+      std::cerr << std::dec << std::endl;
+   return mismatches ? 1 : 0;
+}
+
+int AluTest(unsigned int operations)
+{
+   static const word edges[] = { 0, 1, 2, 0x0F, 0x10, 0x7E, 0x7F, 0x80, 0x81, 0xFE, 0xFF, 0x100, 0x7FFF, 0x8000, 0x8001, 0xFFFE, 0xFFFF };
+   std::mt19937 random(8086);
+   auto operand = [&]() { return random() % 4 == 0 ? edges[random() % std::size(edges)] : (word)random(); };
+   ALU alu;
+   int failed = 0;
+   for (unsigned int i = 0; i < operations; i++) {
+      const int operation = random() % 9;
+      const word a = operand(), b = operand();
+      if (random() % 4 == 0) // and sometimes the flags materialized first
+         alu.current();
+      failed += random() & 1 ? AluCheck<byte>(alu, operation, (byte)a, (byte)b) : AluCheck<word>(alu, operation, a, b);
+   }
+   std::cerr << operations << " operations, " << failed << " failed" << std::endl;
+   return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+   // 8086 -b image instructions
+   // Run the image with tracing off, binary and text; the text trace goes to stdout, results to stderr
+   if (argc == 4 && std::string(argv[1]) == "-b") {
+      Benchmark(argv[2], std::stoul(argv[3]));
+      return 0;
+   }
+   // 8086 -a operations
+   // Check the ALU's results and status flags against reference values; exit status 1 if any differ
+   if (argc == 3 && std::string(argv[1]) == "-a")
+      return AluTest(std::stoul(argv[2]));
+   // 8086 -f outer
+   // Run the same floating point loop with the 8087 kept in double and in temporary real, results to stderr
+   if (argc == 3 && std::string(argv[1]) == "-f") {
+      FpuBenchmark<double>("double:   ", std::stoul(argv[2]));
+      FpuBenchmark<Extended>("extended: ", std::stoul(argv[2]));
+      return 0;
+   }
+
+   // Boot from the floppy image: it is mapped rather than loaded, and INT 13h reads it on demand
+   Disk disk("Microsoft DOS 6.0 (3.5)/Full.img", 0x00);
+   I8086 state(new Memory(), new IO);
+   state.attach(&disk);
+   state.bootstrap();
+
+   // 8086 -s instructions
+   // Run headless, then print the text screen
+   // 8086 -d instructions
+   // Show the text screen in the terminal as it changes, redrawing the changed cells every slice of instructions
+   if (argc == 3 && (std::string(argv[1]) == "-s" || std::string(argv[1]) == "-d")) {
+      const bool live = std::string(argv[1]) == "-d";
+      unsigned long remaining = std::stoul(argv[2]);
+      while (remaining > 0) {
+         const unsigned int slice = live ? (unsigned int)std::min(remaining, 100'000ul) : (unsigned int)remaining;
+         const unsigned int executed = state.run(slice);
+         if (live)
+            state.display().render(std::cout);
+         if (executed < slice) // halted with interrupts disabled
+            break;
+         remaining -= slice;
+      }
+      if (!live)
+         state.display().snapshot(std::cout);
+      return 0;
+   }
+   state.run<I8086::Trace::Text>(77);
+}
@@ -1,80 +1,75 @@
 #include "alu.h"
 
 void ALU::Flags::clear() {
-   O = D = I = T = S = Z = A = P = C = 0;
+   value = 2;
+}
+
+namespace {
+   // Jcc conditions (IA V2 p271) as a mask of FLAGS bits that are all clear (clear=true) or not all clear (clear=false)
+   // SF<>OF is put in the unused bit 12 before the test
+   constexpr int SO_FLAG = 1 << 0xC;
+   struct Condition { int mask; bool clear; };
+   constexpr Condition conditions[16] = {
+      { ALU::O_FLAG,               false }, // 0x0 overflow (OF=1)
+      { ALU::O_FLAG,               true  }, // 0x1 not overflow (OF=0)
+      { ALU::C_FLAG,               false }, // 0x2 below/carry/not above or equal (CF=1)
+      { ALU::C_FLAG,               true  }, // 0x3 above or equal/not below/not carry (CF=0)
+      { ALU::Z_FLAG,               false }, // 0x4 equal/zero (ZF=1)
+      { ALU::Z_FLAG,               true  }, // 0x5 not eqaul/not zero (ZF=0)
+      { ALU::C_FLAG | ALU::Z_FLAG, false }, // 0x6 below or equal/not above (CF=1 or ZF = 1)
+      { ALU::C_FLAG | ALU::Z_FLAG, true  }, // 0x7 above/not below or equal (CF=0 and ZF=0)
+      { ALU::S_FLAG,               false }, // 0x8 sign (SF=1)
+      { ALU::S_FLAG,               true  }, // 0x9 not sign (SF=0)
+      { ALU::P_FLAG,               false }, // 0xA parity/parity even (PF=1)
+      { ALU::P_FLAG,               true  }, // 0xB not parity/parity odd (PF=0)
+      { SO_FLAG,                   false }, // 0xC less/not greater or equal (SF<>OF)
+      { SO_FLAG,                   true  }, // 0xD greater or equal/not less (SF=OF)
+      { ALU::Z_FLAG | SO_FLAG,     false }, // 0xE less or equal/not greater (ZF=1 or SF<>OF)
+      { ALU::Z_FLAG | SO_FLAG,     true  }, // 0xF greater/not less or equal (ZF=0 and SF=OF)
+   };
 }
 
 bool ALU::condition(int test) {
-   switch (test) {
-   case 0x0: return flags.O == 1;                       // overflow (OF=1)                            (IA V2 p271)
-   case 0x1: return flags.O == 0;                       // not overflow (OF=0)                        (IA V2 p271)
-   case 0x2: return flags.C == 1;                       // below/carry/not above or equal (CF=1)      (IA V2 p271)
-   case 0x3: return flags.C == 0;                       // above or equal/not below/not carry (CF=0)  (IA V2 p271)
-   case 0x4: return flags.Z == 1;                       // equal/zero (ZF=1)                          (IA V2 p271)
-   case 0x5: return flags.Z == 0;                       // not eqaul/not zero (ZF=0)                  (IA V2 p271)
-   case 0x6: return flags.C == 1 || flags.Z == 1;       // below or equal/not above (CF=1 or ZF = 1)  (IA V2 p271)
-   case 0x7: return flags.C == 0 && flags.Z == 0;       // above/not below or equal (CF=0 and ZF=0)   (IA V2 p271)
-   case 0x8: return flags.S == 1;                       // sign (SF=1)                                (IA V2 p271)
-   case 0x9: return flags.S == 0;                       // not sign (SF=0)                            (IA V2 p271)
-   case 0xA: return flags.P == 1;                       // parity/parity even (PF=1)                  (IA V2 p271)
-   case 0xB: return flags.P == 0;                       // not parity/parity odd (PF=0)               (IA V2 p271)
-   case 0xC: return flags.S != flags.O;                 // less/not greater or equal (SF<>OF)         (IA V2 p271)
-   case 0xD: return flags.S == flags.O;                 // greater or equal/not less (SF=OF)          (IA V2 p271)
-   case 0xE: return flags.Z == 1 || flags.S != flags.O; // less or equal/not greater (ZF=1 or SF<>OF) (IA V2 p271)
-   default:  return flags.Z == 0 && flags.S == flags.O; // greater/not less or equal (ZF=0 and SF=OF) (IA V2 p271)
+   const Condition& c = conditions[test & 0xF];
+   int value;
+   if (!lazy.defined) {
+      value = flags.value;
+      value |= ((value >> 0x7 ^ value >> 0xB) & 1) << 0xC; // SF<>OF
+   } else {
+      // Only the flags the condition tests, worked out from the pending record, which is kept
+      value = 0;
+      if (c.mask & C_FLAG)  value |= CF() << 0x0;
+      if (c.mask & P_FLAG)  value |= PF() << 0x2;
+      if (c.mask & Z_FLAG)  value |= ZF() << 0x6;
+      if (c.mask & S_FLAG)  value |= SF() << 0x7;
+      if (c.mask & O_FLAG)  value |= OF() << 0xB;
+      if (c.mask & SO_FLAG) value |= (SF() ^ OF()) << 0xC;
    }
+   return ((value & c.mask) == 0) == c.clear;
 }
 
 template<> void ALU::Flags::set(byte x) {
-   C = x & (1 << 0x0) ? 1 : 0;
-   P = x & (1 << 0x2) ? 1 : 0;
-   A = x & (1 << 0x4) ? 1 : 0;
-   Z = x & (1 << 0x6) ? 1 : 0;
-   S = x & (1 << 0x7) ? 1 : 0;
+   // S, Z, A, P and C; the upper half is kept
+   value = (word)((value & 0xFF00) | (x & 0xD5) | 2);
 }
 
 template<> void ALU::Flags::set(word x) {
-   C = x & (1 << 0x0) ? 1 : 0;
-   P = x & (1 << 0x2) ? 1 : 0;
-   A = x & (1 << 0x4) ? 1 : 0;
-   Z = x & (1 << 0x6) ? 1 : 0;
-   S = x & (1 << 0x7) ? 1 : 0;
-   T = x & (1 << 0x8) ? 1 : 0;
-   I = x & (1 << 0x9) ? 1 : 0;
-   D = x & (1 << 0xA) ? 1 : 0;
-   O = x & (1 << 0xB) ? 1 : 0;
+   value = (word)((x & 0x0FD5) | 2);
 }
 
 template<> byte ALU::Flags::get() {
    // bit 1 is always set in modern CPUs (IA V1 p51:Figure 3-7)
    // bit 1 is undefined in original (8086 Family p2-33:Figure 2-32)
-   return (byte)(
-      2 // Use modern standard
-      | (C << 0x0)
-      | (P << 0x2)
-      | (A << 0x4)
-      | (Z << 0x6)
-      | (S << 0x7));
+   return (byte)value;
 }
 
 template<> word ALU::Flags::get() {
-   // bit 1 is always set in modern CPUs (IA V1 p51:Figure 3-7)
-   // bit 1 is undefined in original (8086 Family p2-33:Figure 2-32)
-   return (word)(
-      2 // Use modern standard
-      | (C << 0x0)
-      | (P << 0x2)
-      | (A << 0x4)
-      | (Z << 0x6)
-      | (S << 0x7)
-      | (T << 0x8)
-      | (I << 0x9)
-      | (D << 0xA)
-      | (O << 0xB));
+   return value;
 }
 
 template<>
 void ALU::MUL(word& overflow, word& op1, word op2) {
+   materialize();
    union { uint32_t full; struct { word high; word low; }; } temp;
    temp.full = (int)op1 * (int)op2;
    overflow = temp.high;
@@ -85,6 +80,7 @@ void ALU::MUL(word& overflow, word& op1, word op2) {
 
 template<>
 void ALU::MUL(byte& overflow, byte& op1, byte op2) {
+   materialize();
    union { word full; struct { byte high; byte low; }; } temp;
    temp.full = (int)op1 * (int)op2;
    overflow = temp.high;
@@ -95,6 +91,7 @@ void ALU::MUL(byte& overflow, byte& op1, byte op2) {
 
 template<>
 void ALU::IMUL(word& overflow, word& op1, word op2) {
+   materialize();
    union { uint32_t full; struct { word high; word low; }; } temp;
    temp.full = (int)op1 * (int)op2;
    overflow = temp.high;
@@ -105,6 +102,7 @@ void ALU::IMUL(word& overflow, word& op1, word op2) {
 
 template<>
 void ALU::IMUL(byte& overflow, byte& op1, byte op2) {
+   materialize();
    union { word full; struct { byte high; byte low; }; } temp;
    temp.full = (int)op1 * (int)op2;
    overflow = temp.high;
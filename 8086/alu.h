@@ -20,7 +20,7 @@ public:
       /// The ADD instruction does not distinguish between signed or unsigned operands (IA V2 3-17:Description)
       /// Both operands may be signed or unsigned binary numbers (8086 Family 2-35:ADD)
       unsigned int res = (unsigned int)(op1)+(unsigned int)(op2);
-      setArithemticFlags<T>(op1, op2, res);
+      record<T>(op1, op2, res, ARITHMETIC);
       return (T)res;
    }
 
@@ -34,7 +34,7 @@ public:
    template<typename T>
    T _or(T op1, T op2) {
       T res = op1 | op2;
-      setLogicFlags<T>(res);
+      record<T>(op1, op2, res, LOGIC);
       return res;
    }
 
@@ -48,8 +48,8 @@ public:
    T adc(T op1, T op2) {
       /// The ADC instruction does not distiguish between signed or unsigned operands (IA V2 3-15:Description)
       /// Both operands may be signed or unsigned binary numbers (8086 Family 2-35:ADC)
-      unsigned int res = (unsigned int)op1 + (unsigned int)op2 + (unsigned int)flags.C;
-      setArithemticFlags(op1, op2, res);
+      unsigned int res = (unsigned int)op1 + (unsigned int)op2 + (unsigned int)CF();
+      record<T>(op1, op2, res, ARITHMETIC);
       return (T)res;
    }
 
@@ -63,8 +63,8 @@ public:
    T sbb(T op1, T op2) {
       /// The SBB instruction does not distinguish between signed or unsigned operands (IA V2 3-420:Description)
       /// Both operands may be signed or unsigned binary numbers (8086 Family 2-36:SBB)
-      unsigned int res = (unsigned int)op1 - (unsigned int)(op2 + flags.C);
-      setArithemticFlags(op1, op2, res);
+      unsigned int res = (unsigned int)op1 - (unsigned int)(op2 + CF());
+      record<T>(op1, op2, res, ARITHMETIC, true);
       return (T)res;
    }
 
@@ -78,7 +78,7 @@ public:
    template<typename T>
    T _and(T op1, T op2) {
       T res = op1 & op2;
-      setLogicFlags<T>(res);
+      record<T>(op1, op2, res, LOGIC);
       return res;
    }
 
@@ -93,7 +93,7 @@ public:
       /// The SUB instruction does not distinguish between signed or unsigned operands (IA V2 3-448:Description)
       /// Both operands may be signed or unsigned binary numbers (8086 Family 2-36:SUB)
       unsigned int res = (unsigned int)op1 - (unsigned int)op2;
-      setArithemticFlags<T>(op1, op2, res);
+      record<T>(op1, op2, res, ARITHMETIC, true);
       return (T)res;
    }
 
@@ -107,7 +107,7 @@ public:
    template<typename T>
    T _xor(T op1, T op2) {
       T res = op1 ^ op2;
-      setLogicFlags<T>(res);
+      record<T>(op1, op2, res, LOGIC);
       return res;
    }
 
@@ -143,6 +143,7 @@ public:
    //    maximum count of 31.
    template<typename T>
    T ROL(T dest, unsigned int cnt) {
+      materialize();
       // This emulator, staying true to the original 8086, will not mask the rotation count
       for (; cnt > 0; --cnt) {
          flags.C = MSB(dest);
@@ -182,6 +183,7 @@ public:
    //    maximum count of 31.
    template<typename T>
    T ROR(T dest, unsigned int cnt) {
+      materialize();
       const T highBit = ~((T)(-1) >> 1); // 0x80..00
       // This emulator, staying true to the original 8086, will not mask the rotation count
       for (; cnt > 0; --cnt) {
@@ -223,6 +225,7 @@ public:
    //    maximum count of 31.
    template<typename T>
    T RCL(T dest, unsigned int cnt) {
+      materialize();
       int CF;
       // This emulator, staying true to the original 8086, will not mask the rotation count
       for (; cnt > 0; --cnt) {
@@ -265,6 +268,7 @@ public:
    //    maximum count of 31.
    template<typename T>
    T RCR(T dest, unsigned int cnt) {
+      materialize();
       const T highBit = ~((T)(-1) >> 1); // 0x80..00
 
       int CF;
@@ -313,6 +317,7 @@ public:
    template<typename T>
    T SHL(T dest, unsigned int cnt) {
       if (cnt == 0) return dest; // All flags remain unchanged if cnt=0
+      materialize();
       // This emulator, staying true to the original 8086, will not mask the rotation count
       for (; cnt > 0; --cnt) {
          flags.C = MSB(dest); // Valid only if cnt < numbits(dest)
@@ -355,6 +360,7 @@ public:
    template<typename T>
    T SHR(T dest, unsigned int cnt) {
       if (cnt == 0) return dest; // All flags remain unchanged if cnt=0
+      materialize();
       // This emulator, staying true to the original 8086, will not mask the rotation count
       for (; cnt > 0; --cnt) {
          flags.C = LSB(dest);
@@ -399,6 +405,7 @@ public:
    template<typename T>
    T SAR(T dest, unsigned int cnt) {
       if (cnt == 0) return dest; // All flags remain unchanged if cnt=0
+      materialize();
       // This emulator, staying true to the original 8086, will not mask the rotation count
       for (; cnt > 0; --cnt) {
          flags.C = LSB(dest);
@@ -430,6 +437,7 @@ public:
    // Flags:
    //    C, A, S, Z, P, O
    byte DAA(byte AL) {
+      materialize();
       if (((AL & 0xF) > 9) || (flags.A == 1)) {
          word temp = (word)AL + 6;
          AL = temp & 0xff;
@@ -465,6 +473,7 @@ public:
    // Flags:
    //    A, C, O, S, Z, P
    void AAA(byte &AL, byte &AH) {
+      materialize();
       if (((AL & 0xF) > 9) || (flags.A == 1)) {
          AL += 6;
          ++AH;
@@ -480,6 +489,7 @@ public:
    }
 
    void AAS(byte &AH, byte &AL) {
+      materialize();
       if (((AL & 0xF) > 9) || (flags.A == 1)) {
          AL -= 6;
          AH -= 1;
@@ -494,6 +504,7 @@ public:
    }
 
    void DAS(byte &AL) {
+      materialize();
       if (((AL & 0xF) > 9) || (flags.A == 1)) {
          word temp = (word)AL - 6;
          AL = temp & 0xFF;
@@ -517,9 +528,8 @@ public:
    //    O, S, Z, A, P
    template<typename T>
    T INC(T op) {
-      auto C = flags.C; // save carry flag
-      T result = add<T>(op, 1);
-      flags.C = C; // restore carry flag
+      T result = (T)(op + 1);
+      record<T>(op, 1, (unsigned int)op + 1, ARITHMETIC & ~C_FLAG); // carry flag kept
       return result;
    }
 
@@ -531,9 +541,8 @@ public:
    //    O, S, Z, A, P
    template<typename T>
    T DEC(T op) {
-      auto C = flags.C; // save carry flag
-      T result = sub<T>(op, 1);
-      flags.C = C; // restore carry flag
+      T result = (T)(op - 1);
+      record<T>(op, 1, (unsigned int)op - 1, ARITHMETIC & ~C_FLAG, true); // carry flag kept
       return result;
    }
 
@@ -550,6 +559,7 @@ public:
 
    template<typename T>
    void NEG(T& op) {
+      materialize();
       op = -op;
       setFlags<word>(op);
       setLogicFlags<word>(op);
@@ -573,6 +583,8 @@ public:
    void setFlags(T value) {
       const T signBit = ~((T)(-1) >> 1); // 0x80..0 (high-order bit mask)
 
+      materialize(); // the other status flags stay as they were
+
       /// If the result of an arithmetic or logical operation is zero,...
       flags.Z = value == 0 ? 1 : 0; /// ...then Z is set; otherwise Z is cleared.
 
@@ -586,29 +598,93 @@ public:
       /// Source: 8086 Family 2-35
    }
 
-   // Compute C,O,A flags for arithmetic operations (along with Z,S,P flags)
+   // Lazy flags:
+   // The arithmetic and logic operations above only record their operands and unmasked result;
+   // the status flags are worked out from that record when something asks for them.
+   // Flags the record defines are stale in `flags` until materialize() is called.
+   // Bit positions are those of the FLAGS register (8086 Family p2-33:Figure 2-32).
+   enum : int {
+      C_FLAG = 1 << 0x0, P_FLAG = 1 << 0x2, A_FLAG = 1 << 0x4,
+      Z_FLAG = 1 << 0x6, S_FLAG = 1 << 0x7, O_FLAG = 1 << 0xB,
+      ARITHMETIC = O_FLAG | S_FLAG | Z_FLAG | A_FLAG | P_FLAG | C_FLAG,
+      LOGIC = O_FLAG | S_FLAG | Z_FLAG | P_FLAG | C_FLAG // A is left as it was (undefined)
+   };
+   struct Lazy {
+      unsigned int op1, op2, res;
+      unsigned int signBit;     // 0x80 or 0x8000
+      int defined = 0;          // flags computed from this record; the rest are in `flags`
+      bool logic;
+      bool subtract;            // res is op1 - op2 (SUB, SBB, CMP, DEC), otherwise op1 + op2
+   } lazy;
+
+   // Record an operation. Flags the previous record defined but this one doesn't are saved first.
    template<typename T>
-   void setArithemticFlags(T op1, T op2, unsigned int res) {
-      const T signBit = ~((T)(-1) >> 1); // 0x80..0 (high-order bit mask)
-      const unsigned int overflow = ((int)(-1) - (T)(-1)); // 0xFF..FF00..00 Should be as many zeros as bits in T
-
-      // Take care of Z,S,P flags
-      setFlags<T>((T)res);
-
-      // TODO: Test all of this
-
-      /// If an addition results in a carry out of the high-order bit of the result,...
-      /// If a subtraction results in a borrow into the high-order bit of the result,...
-      flags.C = (res & overflow) ? 1 : 0; /// ...then C is set; otherwise C is cleared.
-
-      /// If the result on an operation is too large a positive number, or too small a negative number to fit in the destination operand (exluding the sign bit),...
-      flags.O = (res ^ op1) & (res ^ op2) & signBit ? 1 : 0; /// ...then O is set otherwise O is cleared.
+   void record(T op1, T op2, unsigned int res, int defined, bool subtract = false) {
+      if (int keep = lazy.defined & ~defined) {
+         if (keep & C_FLAG) flags.C = CF();
+         if (keep & A_FLAG) flags.A = AF();
+         // INC/DEC keep only C and logic operations only A, so no other flag can be left over
+      }
+      lazy.op1 = op1;
+      lazy.op2 = op2;
+      lazy.res = res;
+      lazy.signBit = (T)~((T)(-1) >> 1);
+      lazy.defined = defined;
+      lazy.logic = (defined == LOGIC);
+      lazy.subtract = subtract;
+   }
 
-      /// If an addition results in a carry out of the low-order half-byte of the result,...
-      /// If a subtraction results in a borrow into the low-order half-byte of the result,...
-      flags.A = ((op1 ^ op2 ^ res) & 0x10) ? 1 : 0; // ...then A is set; otherwise A is cleared.
+   // Individual status flags, taken from the last recorded operation when it defines them
 
-      /// Source: 8086 Family 2-35
+   /// If an addition results in a carry out of the high-order bit of the result,...
+   /// If a subtraction results in a borrow into the high-order bit of the result,...
+   /// ...then C is set; otherwise C is cleared.
+   /// The overflow (OF) and carry (CF) flags are always cleared by logical instructions
+   int CF() const {
+      if (!(lazy.defined & C_FLAG)) return flags.C;
+      return !lazy.logic && (lazy.res & ~(lazy.signBit * 2 - 1)) ? 1 : 0;
+   }
+   /// If the low-order eight bits of an arithmetic or logical result contain an even number of 1-bits,...
+   /// ...then the parity flag is set; otherwise it is cleared.
+   int PF() const {
+      if (!(lazy.defined & P_FLAG)) return flags.P;
+      return parity[lazy.res & 0xff];
+   }
+   /// If an addition results in a carry out of the low-order half-byte of the result,...
+   /// If a subtraction results in a borrow into the low-order half-byte of the result,...
+   /// ...then A is set; otherwise A is cleared.
+   int AF() const {
+      if (!(lazy.defined & A_FLAG)) return flags.A;
+      return ((lazy.op1 ^ lazy.op2 ^ lazy.res) & 0x10) ? 1 : 0;
+   }
+   /// If the result of an arithmetic or logical operation is zero, then Z is set; otherwise Z is cleared.
+   int ZF() const {
+      if (!(lazy.defined & Z_FLAG)) return flags.Z;
+      return (lazy.res & (lazy.signBit * 2 - 1)) == 0 ? 1 : 0;
+   }
+   /// Arithmetic and logical instructions set the sign flag equal to the high-order bit (bit 7 or 15) of the result.
+   int SF() const {
+      if (!(lazy.defined & S_FLAG)) return flags.S;
+      return (lazy.res & lazy.signBit) ? 1 : 0;
+   }
+   /// If the result on an operation is too large a positive number, or too small a negative number
+   /// to fit in the destination operand (exluding the sign bit), then O is set otherwise O is cleared.
+   int OF() const {
+      if (!(lazy.defined & O_FLAG)) return flags.O;
+      if (lazy.logic) return 0;
+      // Adding operands of the same sign, or subtracting one of the other sign, gave a result of the other sign
+      const unsigned int overflow = lazy.subtract ? (lazy.op1 ^ lazy.op2) & (lazy.op1 ^ lazy.res)
+                                                  : (lazy.res ^ lazy.op1) & (lazy.res ^ lazy.op2);
+      return (overflow & lazy.signBit) ? 1 : 0;
+   }
+   /// Source: 8086 Family 2-35, 2-38
+
+   // Write the recorded status flags into `flags`
+   void materialize() {
+      if (!lazy.defined) return;
+      int computed = CF() << 0x0 | PF() << 0x2 | AF() << 0x4 | ZF() << 0x6 | SF() << 0x7 | OF() << 0xB;
+      flags.value = (word)((flags.value & ~lazy.defined) | (computed & lazy.defined));
+      lazy.defined = 0;
    }
 
    // Clear O, C flags. Compute S, Z, P flags for logical operations
@@ -617,6 +693,7 @@ public:
       /// AND, OR, XOR, and TEST affect the flags as follows:
       /// The overflow (OF) and carry (CF) flags are always cleared by logical instructions,
       /// and the contents of the auxiliary carry (AF) is always undefined following execution of a logical instruction.
+      materialize();
       flags.C = flags.O = 0;
       /// The sign (SF), zero (ZF)  and parity (PF) flags are always posted to refect the result of the operation.
       setFlags<T>(value); // Set Z,S,P flags
@@ -631,46 +708,60 @@ public:
       // F E D C B A 9 8 7 6 5 4 3 2 1 0
       // - - - - O D I T S Z - A - P - C
       // (8086 Family p2-33:Figure 2-32)
-
-      // An arithmetic overflow has occurred.
-      // An Interrupt On Overflow instruction is available (which?)
-      int O = 0; // Overflow
-      // When set, string instructions auto-decrement;
-      // that is, to processs strings from high addresses to low addresses,
-      // or from "right to left". Clearing causes "left to right"
-      int D = 0; // Direction
-      // Setting allows CPU to recognize external (maskable) interrupt requests.
-      // This flag has no affect on either non-maskable external or internally generated interrupts.
-      int I = 0; // Interrupt
-      // Setting this puts the CPU into single-step mode for debugging.
-      // In this mode, the CPU automatically generates an internal interrupt after each instruction.
-      int T = 0; // Trap
-      // If set, the high-order bit of the result is 1.
-      // 0 => positive, 1 => negative
-      int S = 0; // Sign
-      // Result of operation is zero
-      int Z = 0; // Zero
-      // There has been a
-      //    carry out of the low nibble into the high nibble
-      // or a
-      //    borrow from the high nibble into the low nibble
-      // of an 8-bit quantity (low-order byte of a 16-bit quantity)
-      int A = 0; // Auxiliary Carry
-      // If set, the result has even parity, an even number of 1-bits
-      int P = 0; // Parity
-      // There has been a
-      //    carry out of, or a borrow into,
-      // the high-order bit of the result (8- or 16-bit)
-      int C = 0; // Carry
+      // Kept in this layout, so PUSHF/POPF and interrupts copy the word as is
+      union {
+         word value = 2; // bit 1 is always set in modern CPUs (IA V1 p51:Figure 3-7)
+         struct {
+            // There has been a
+            //    carry out of, or a borrow into,
+            // the high-order bit of the result (8- or 16-bit)
+            word C : 1; // Carry
+            word   : 1;
+            // If set, the result has even parity, an even number of 1-bits
+            word P : 1; // Parity
+            word   : 1;
+            // There has been a
+            //    carry out of the low nibble into the high nibble
+            // or a
+            //    borrow from the high nibble into the low nibble
+            // of an 8-bit quantity (low-order byte of a 16-bit quantity)
+            word A : 1; // Auxiliary Carry
+            word   : 1;
+            // Result of operation is zero
+            word Z : 1; // Zero
+            // If set, the high-order bit of the result is 1.
+            // 0 => positive, 1 => negative
+            word S : 1; // Sign
+            // Setting this puts the CPU into single-step mode for debugging.
+            // In this mode, the CPU automatically generates an internal interrupt after each instruction.
+            word T : 1; // Trap
+            // Setting allows CPU to recognize external (maskable) interrupt requests.
+            // This flag has no affect on either non-maskable external or internally generated interrupts.
+            word I : 1; // Interrupt
+            // When set, string instructions auto-decrement;
+            // that is, to processs strings from high addresses to low addresses,
+            // or from "right to left". Clearing causes "left to right"
+            word D : 1; // Direction
+            // An arithmetic overflow has occurred.
+            // An Interrupt On Overflow instruction is available (which?)
+            word O : 1; // Overflow
+            word   : 4;
+         };
+      };
 
       template<typename T> void set(T); // Set flags
       template<typename T> T get(); // Get flags in byte/word format
       void clear();
    } flags;
+   static_assert(sizeof(Flags) == 2, "FLAGS bit-fields must pack into one word");
+
+   // All flags, status flags included, ready to read or write (PUSHF, POPF, LAHF, SAHF, interrupts).
+   // The control flags D, I and T are always current and can be used through `flags` directly.
+   Flags& current() { materialize(); return flags; }
 private:
 
    // Lookup table for parity of a byte
-   const int parity[256] = {
+   static constexpr int parity[256] = {
       1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1,
       0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,
       0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0,